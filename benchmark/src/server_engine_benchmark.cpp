@@ -0,0 +1,250 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+
+// project
+#include "ltb/net/server/engine_server.hpp"
+
+#if defined(__cpp_impl_coroutine)
+#include "ltb/net/coro/server_task.hpp"
+#endif
+
+// generated
+#include "testing.grpc.pb.h"
+
+// external
+#include <grpc++/channel.h>
+#include <grpc++/client_context.h>
+
+// standard
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Service     = grpcw::testing::protocol::Test;
+using TestMessage = grpcw::testing::protocol::TestMessage;
+using Clock       = std::chrono::steady_clock;
+
+struct BenchmarkConfig {
+    std::size_t calls         = 100'000u;
+    std::size_t concurrency   = 64u; ///< Calls kept in flight
+    std::size_t payload_bytes = 32u;
+};
+
+struct BenchmarkResult {
+    double              seconds   = 0.0;
+    std::size_t         errors    = 0u;
+    std::vector<double> latencies = {}; ///< Microseconds, sorted
+};
+
+struct PendingCall {
+    grpc::ClientContext                                           context;
+    TestMessage                                                   response;
+    grpc::Status                                                  status;
+    std::unique_ptr<grpc::ClientAsyncResponseReader<TestMessage>> reader;
+    Clock::time_point                                             start;
+};
+
+/// \brief Keeps 'concurrency' echo calls in flight until 'calls' have completed.
+auto run_echo_load(std::shared_ptr<grpc::Channel> const& channel, BenchmarkConfig const& config) -> BenchmarkResult {
+    auto stub = Service::NewStub(channel);
+
+    TestMessage request;
+    request.set_msg(std::string(config.payload_bytes, 'x'));
+
+    grpc::CompletionQueue queue;
+    std::size_t           started = 0u;
+
+    auto start_call = [&] {
+        auto* call   = new PendingCall();
+        call->start  = Clock::now();
+        call->reader = stub->Asyncecho(&call->context, request, &queue);
+        call->reader->Finish(&call->response, &call->status, call);
+        ++started;
+    };
+
+    BenchmarkResult result;
+    result.latencies.reserve(config.calls);
+
+    auto start_time = Clock::now();
+    while (started < std::min(config.concurrency, config.calls)) {
+        start_call();
+    }
+
+    void* tag = nullptr;
+    bool  ok  = false;
+    while (result.latencies.size() < config.calls && queue.Next(&tag, &ok)) {
+        auto call = std::unique_ptr<PendingCall>(static_cast<PendingCall*>(tag));
+        result.latencies.emplace_back(
+            std::chrono::duration<double, std::micro>(Clock::now() - call->start).count());
+        if (!ok || !call->status.ok()) {
+            ++result.errors;
+        }
+        if (started < config.calls) {
+            start_call();
+        }
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start_time).count();
+
+    queue.Shutdown();
+    while (queue.Next(&tag, &ok)) {
+    }
+
+    std::sort(result.latencies.begin(), result.latencies.end());
+    return result;
+}
+
+auto percentile(std::vector<double> const& sorted_values, double fraction) -> double {
+    if (sorted_values.empty()) {
+        return 0.0;
+    }
+    auto index = static_cast<std::size_t>(fraction * static_cast<double>(sorted_values.size() - 1u));
+    return sorted_values[index];
+}
+
+auto echo(TestMessage const& request, ltb::net::AsyncServerUnaryWriter<TestMessage> writer) -> void {
+    writer.finish(request, grpc::Status::OK);
+}
+
+/// \brief Serves the testing echo method with 'Server' over an in-process channel and
+///        drives it with the same client load as every other engine.
+template <typename Server, typename Handler>
+auto benchmark_engine(std::string const& engine_name, BenchmarkConfig const& config, Handler handler) -> void {
+    Server server(""); // In-process only so the comparison is not dominated by the network.
+
+    server.register_rpc(&Service::AsyncService::Requestecho, std::move(handler));
+
+    auto channel = server.grpc_server().InProcessChannel({});
+
+    // The servers log every event, which would otherwise dominate the measurement.
+    std::cout.setstate(std::ios::failbit);
+
+    std::thread run_thread([&server] { server.run(); });
+
+    auto warm_up  = config;
+    warm_up.calls = std::max(config.calls / 10u, config.concurrency);
+    run_echo_load(channel, warm_up);
+
+    auto result = run_echo_load(channel, config);
+
+    server.shutdown();
+    run_thread.join();
+
+    std::cout.clear();
+    std::cout << std::left << std::setw(18) << engine_name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << (static_cast<double>(result.latencies.size()) / result.seconds)
+              << std::setw(10) << percentile(result.latencies, 0.5) << std::setw(10)
+              << percentile(result.latencies, 0.99) << std::setw(10) << result.errors << std::endl;
+}
+
+} // namespace
+
+auto main(int argc, const char* argv[]) -> int {
+    auto            run_completion_queue = true;
+    auto            run_callback         = true;
+    auto            run_coroutine        = true;
+    BenchmarkConfig config;
+
+    auto display_help_message = [] {
+        std::cout << "run_ltb_net_server_engine_benchmark [engine] [calls] [concurrency] [payload_bytes]\n"
+                  << "engine        - 'completion_queue', 'callback', 'coroutine' or 'all' (default)\n"
+                  << "calls         - Echo calls to measure, defaults to 100000\n"
+                  << "concurrency   - Calls kept in flight, defaults to 64\n"
+                  << "payload_bytes - Size of each request, defaults to 32\n"
+                  << std::endl;
+    };
+
+    if (argc > 1) {
+        std::string engine = argv[1];
+
+        if (engine == "--help" || engine == "-h") {
+            display_help_message();
+            return EXIT_SUCCESS;
+        } else if (engine != "all") {
+            run_completion_queue = (engine == "completion_queue");
+            run_callback         = (engine == "callback");
+            run_coroutine        = (engine == "coroutine");
+        }
+
+        if (!run_completion_queue && !run_callback && !run_coroutine) {
+            std::cerr << "ERROR: unknown engine '" << engine << "'" << std::endl;
+            display_help_message();
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc > 2) {
+        config.calls = std::stoul(argv[2]);
+    }
+    if (argc > 3) {
+        config.concurrency = std::max(std::stoul(argv[3]), 1ul);
+    }
+    if (argc > 4) {
+        config.payload_bytes = std::stoul(argv[4]);
+    }
+
+    std::cout << "calls: " << config.calls << ", concurrency: " << config.concurrency
+              << ", payload: " << config.payload_bytes << " bytes\n"
+              << std::left << std::setw(18) << "engine" << std::right << std::setw(12) << "calls/s"
+              << std::setw(10) << "p50 us" << std::setw(10) << "p99 us" << std::setw(10) << "errors" << std::endl;
+
+    using ltb::net::ServerEngine;
+
+    if (run_completion_queue) {
+        using Server = ltb::net::EngineServer<Service::AsyncService, ServerEngine::CompletionQueue>;
+        benchmark_engine<Server>("completion_queue", config, echo);
+    }
+    if (run_callback) {
+        using Server = ltb::net::EngineServer<Service::AsyncService, ServerEngine::Callback>;
+        benchmark_engine<Server>("callback", config, echo);
+    }
+    if (run_coroutine) {
+#if defined(__cpp_impl_coroutine)
+        // Same as 'completion_queue' except the handler is a coroutine. Unary coroutine handlers are
+        // still called through the UnaryConnect std::function, so this measures what starting a
+        // pooled coroutine frame adds to each call.
+        using Server = ltb::net::EngineServer<Service::AsyncService, ServerEngine::CompletionQueue>;
+        benchmark_engine<Server>(
+            "coroutine",
+            config,
+            [](TestMessage const&                            request,
+               ltb::net::AsyncServerUnaryWriter<TestMessage> writer) -> ltb::net::ServerTask {
+                writer.finish(request, grpc::Status::OK);
+                co_return;
+            });
+#else
+        if (argc > 1 && std::string(argv[1]) == "coroutine") {
+            std::cerr << "ERROR: the 'coroutine' engine needs a build with LTB_NET_ENABLE_COROUTINES=ON" << std::endl;
+            return EXIT_FAILURE;
+        }
+#endif
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,112 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "adaptive_concurrency_limit.hpp"
+
+// external
+#include <doctest/doctest.h>
+
+// standard
+#include <algorithm>
+#include <cmath>
+
+namespace ltb::net {
+
+AdaptiveConcurrencyLimit::AdaptiveConcurrencyLimit(AdaptiveConcurrencyOptions options)
+    : options_(options), limit_(static_cast<double>(options.initial_limit)) {}
+
+auto AdaptiveConcurrencyLimit::on_sample(util::Duration rtt, std::size_t in_flight, bool dropped) -> void {
+    if (rtt <= util::Duration::zero()) {
+        return;
+    }
+
+    if (options_.probe_interval > 0u && ++sample_count_ >= options_.probe_interval) {
+        sample_count_ = 0u;
+        min_rtt_      = util::Duration::zero();
+    }
+    if (min_rtt_ == util::Duration::zero() || rtt < min_rtt_) {
+        min_rtt_ = rtt;
+    }
+
+    auto log_limit = std::max(1.0, std::log10(limit_));
+    auto new_limit = limit_;
+
+    if (dropped) {
+        new_limit = limit_ - log_limit;
+
+    } else if (static_cast<double>(in_flight) * 2.0 >= limit_) {
+        // Only adjust when the limit is actually being used.
+        auto rtt_ratio  = util::to_seconds<double>(min_rtt_) / util::to_seconds<double>(rtt);
+        auto queue_size = std::ceil(limit_ * (1.0 - rtt_ratio));
+
+        auto alpha = 3.0 * log_limit;
+        auto beta  = 6.0 * log_limit;
+
+        if (queue_size <= log_limit) {
+            new_limit = limit_ + beta;
+        } else if (queue_size < alpha) {
+            new_limit = limit_ + log_limit;
+        } else if (queue_size > beta) {
+            new_limit = limit_ - log_limit;
+        }
+    }
+
+    new_limit = limit_ * (1.0 - options_.smoothing) + new_limit * options_.smoothing;
+    limit_    = std::clamp(new_limit, static_cast<double>(options_.min_limit), static_cast<double>(options_.max_limit));
+}
+
+auto AdaptiveConcurrencyLimit::limit() const -> std::size_t {
+    return static_cast<std::size_t>(limit_);
+}
+
+auto AdaptiveConcurrencyLimit::min_rtt() const -> util::Duration {
+    return min_rtt_;
+}
+
+TEST_CASE("[ltb][net] adaptive_concurrency_limit grows when healthy and backs off under queueing") {
+    using namespace std::chrono_literals;
+
+    AdaptiveConcurrencyLimit limit;
+    CHECK(limit.limit() == 20u);
+
+    // RTT stays at the baseline: no queueing so the limit grows.
+    for (auto i = 0; i < 50; ++i) {
+        limit.on_sample(10ms, limit.limit(), false);
+    }
+    auto healthy_limit = limit.limit();
+    CHECK(healthy_limit > 20u);
+
+    // RTT quadruples: requests are queueing on the server so the limit shrinks.
+    for (auto i = 0; i < 50; ++i) {
+        limit.on_sample(40ms, limit.limit(), false);
+    }
+    CHECK(limit.limit() < healthy_limit);
+    CHECK(limit.min_rtt() == 10ms);
+
+    // Failures always shrink the limit, down to the minimum.
+    for (auto i = 0; i < 1000; ++i) {
+        limit.on_sample(10ms, limit.limit(), true);
+    }
+    CHECK(limit.limit() == 1u);
+}
+
+} // namespace ltb::net
@@ -0,0 +1,71 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// project
+#include "ltb/util/duration.hpp"
+
+// standard
+#include <cstddef>
+
+namespace ltb::net {
+
+struct AdaptiveConcurrencyOptions {
+    std::size_t initial_limit = 20u;
+    std::size_t min_limit     = 1u;
+    std::size_t max_limit     = 1000u;
+
+    /// \brief How much of each new limit estimate is blended into the current limit.
+    double smoothing = 1.0;
+
+    /// \brief The minimum RTT baseline is re-measured after this many samples so
+    ///        the limit can recover when the network path changes.
+    std::size_t probe_interval = 1000u;
+};
+
+/// \brief Adjusts an outstanding call limit from measured round trip times (TCP Vegas style).
+///
+/// The queue built up on the server is estimated as 'limit * (1 - min_rtt / rtt)'.
+/// The limit grows while that queue is small and shrinks once it gets large or
+/// calls start failing, so clients back off before the server has to shed load.
+class AdaptiveConcurrencyLimit {
+public:
+    explicit AdaptiveConcurrencyLimit(AdaptiveConcurrencyOptions options = {});
+
+    /// \brief Record a finished call.
+    /// \param rtt - how long the call took.
+    /// \param in_flight - the number of outstanding calls when the call finished (including this one).
+    /// \param dropped - the call failed in a way that suggests overload (timeouts, unavailable, ...).
+    auto on_sample(util::Duration rtt, std::size_t in_flight, bool dropped) -> void;
+
+    [[nodiscard]] auto limit() const -> std::size_t;
+    [[nodiscard]] auto min_rtt() const -> util::Duration;
+
+private:
+    AdaptiveConcurrencyOptions options_;
+    double                     limit_;
+    util::Duration             min_rtt_      = util::Duration::zero();
+    std::size_t                sample_count_ = 0u;
+};
+
+} // namespace ltb::net
@@ -41,6 +41,40 @@ auto to_client_connection_state(grpc_connectivity_state const& state) -> ClientC
     throw std::invalid_argument("Invalid grpc_connectivity_state");
 }
 
+auto aggregate_connection_state(std::vector<ClientConnectionState> const& states) -> ClientConnectionState {
+    if (states.empty()) {
+        return ClientConnectionState::NoHostSpecified;
+    }
+
+    // The client is as connected as its most connected backend.
+    for (auto state : {ClientConnectionState::InterprocessServerAlwaysConnected,
+                       ClientConnectionState::Connected,
+                       ClientConnectionState::AttemptingToConnect,
+                       ClientConnectionState::RecoveringFromFailure,
+                       ClientConnectionState::NotConnected}) {
+        if (std::find(states.begin(), states.end(), state) != states.end()) {
+            return state;
+        }
+    }
+    return ClientConnectionState::Shutdown;
+}
+
+auto is_backend_failure(grpc::Status const& status, bool completed_successfully, bool timed_out) -> bool {
+    if (!completed_successfully || timed_out) {
+        return true;
+    }
+    switch (status.error_code()) {
+    case grpc::StatusCode::UNAVAILABLE:
+    case grpc::StatusCode::RESOURCE_EXHAUSTED:
+    case grpc::StatusCode::DEADLINE_EXCEEDED:
+    case grpc::StatusCode::INTERNAL:
+    case grpc::StatusCode::UNKNOWN:
+        return true;
+    default:
+        return false;
+    }
+}
+
 auto state_notification_deadline() -> std::chrono::time_point<std::chrono::system_clock> {
     return std::chrono::time_point<std::chrono::system_clock>::max();
     // return std::chrono::system_clock::now() + std::chrono::seconds(60);
@@ -24,17 +24,25 @@
 
 // project
 #include "async_client_data.hpp"
+#include "consistent_hash.hpp"
+#include "unary_call_awaitable.hpp"
+#include "ltb/net/event_loop.hpp"
+#include "ltb/net/method_key.hpp"
 #include "ltb/net/tagger.hpp"
 #include "ltb/util/atomic_data.hpp"
 
 // external
+#include <grpc++/alarm.h>
 #include <grpc++/channel.h>
 #include <grpc++/create_channel.h>
 #include <grpc++/server.h>
 
 // standard
+#include <algorithm>
+#include <condition_variable>
 #include <functional>
 #include <unordered_map>
+#include <vector>
 
 namespace ltb::net {
 
@@ -42,153 +50,562 @@ template <typename Service>
 class AsyncClient {
 public:
     explicit AsyncClient(std::string const& host_address);
+    explicit AsyncClient(std::vector<std::string> const& host_addresses);
     explicit AsyncClient(grpc::Server& interprocess_server);
 
+    /// \brief Clients that share the completion queues of 'event_loop' instead of polling
+    ///        their own. run() returns immediately and shutdown() waits for outstanding work.
+    explicit AsyncClient(EventLoop& event_loop, std::string const& host_address);
+    explicit AsyncClient(EventLoop& event_loop, std::vector<std::string> const& host_addresses);
+    explicit AsyncClient(EventLoop& event_loop, grpc::Server& interprocess_server);
+
     using StateChangeCallback = std::function<void(ClientConnectionState)>;
 
+    // Not deducible so lambdas can be passed directly.
+    template <typename Request>
+    using KeyExtractor = typename detail::NonDeduced<std::function<std::string(Request const&)>>::type;
+
     template <typename Request, typename Response>
     using UnaryCallPtr = auto (Service::Stub::*)(grpc::ClientContext*, Request const&, grpc::CompletionQueue*)
                              -> std::unique_ptr<grpc_impl::ClientAsyncResponseReader<Response>>;
 
-    /// \brief Blocks the current thread.
+    /// \brief Blocks the current thread (unless the client is attached to an EventLoop).
     auto run() -> void;
 
     auto shutdown() -> void;
 
     auto on_state_change(StateChangeCallback callback, CallImmediately call_immediately) -> AsyncClient&;
 
+    /// \brief The timeout used by calls that don't set one in their CallOptions.
+    ///        A zero timeout (the default) means calls never time out.
+    auto set_default_timeout(util::Duration timeout) -> AsyncClient&;
+
+    /// \brief Limits the number of calls waiting on a response. A limit of zero removes the limit.
+    auto set_max_outstanding_calls(std::size_t limit, SubmitPolicy policy = SubmitPolicy::FailFast) -> AsyncClient&;
+
+    /// \brief Limits the number of outstanding calls of a single method. A limit of zero removes the limit.
+    template <typename Response, typename Request>
+    auto set_max_outstanding_calls(UnaryCallPtr<Request, Response> unary_call_ptr, std::size_t limit)
+        -> AsyncClient&;
+
+    /// \brief Adjust a separate outstanding call limit for each backend based on measured
+    ///        round trip times. Calls go to another backend, or follow the submit policy,
+    ///        while a backend is at its limit.
+    auto enable_adaptive_concurrency(AdaptiveConcurrencyOptions options = {}) -> AsyncClient&;
+
+    /// \brief Stop sending calls to a backend that keeps failing. Calls go to the other
+    ///        backends, or fail locally if every backend's circuit is open.
+    auto enable_circuit_breaker(CircuitBreakerOptions options = {}) -> AsyncClient&;
+
+    /// \brief Cache successful responses of a read-only method for 'options.ttl'.
+    ///
+    /// Calls with a cached response invoke their callbacks on the completion
+    /// queue thread without being sent to a backend.
+    template <typename Response, typename Request>
+    auto enable_response_cache(UnaryCallPtr<Request, Response> unary_call_ptr, ResponseCacheOptions options = {})
+        -> AsyncClient&;
+
+    /// \brief Share one outstanding call between identical requests to a method.
+    ///
+    /// A call whose serialized request matches an outstanding call to the same
+    /// method is not sent. It completes with the outstanding call's result,
+    /// including its status, errors and deadline.
+    template <typename Response, typename Request>
+    auto enable_request_coalescing(UnaryCallPtr<Request, Response> unary_call_ptr) -> AsyncClient&;
+
+    /// \brief Drop the cached response of 'request'.
+    ///
+    /// Calls sent before the invalidation don't cache their response, and later
+    /// identical calls are sent again instead of joining them.
+    template <typename Response, typename Request>
+    auto invalidate_cached_response(UnaryCallPtr<Request, Response> unary_call_ptr, Request const& request)
+        -> AsyncClient&;
+
+    /// \brief Drop every cached response of a method (see invalidate_cached_response()).
+    template <typename Response, typename Request>
+    auto invalidate_cached_responses(UnaryCallPtr<Request, Response> unary_call_ptr) -> AsyncClient&;
+
+    auto stats() -> AsyncClientStats;
+
+    template <typename Response, typename Request>
+    auto outstanding_calls(UnaryCallPtr<Request, Response> unary_call_ptr) -> std::size_t;
+
+    auto add_backend(std::string const& host_address) -> AsyncClient&;
+    auto remove_backend(std::string const& host_address) -> AsyncClient&;
+
+    /// \brief Send every call of this method with the same key to the same backend.
+    ///
+    /// Backends are chosen with rendezvous hashing so only ~1/N of the keys
+    /// move when a backend is added or removed. Methods without a key extractor
+    /// are sent to the backends in round-robin order.
+    template <typename Response, typename Request>
+    auto route_by_key(UnaryCallPtr<Request, Response> unary_call_ptr, KeyExtractor<Request> key_extractor)
+        -> AsyncClient&;
+
     template <typename Response, typename Request>
     auto unary_rpc(UnaryCallPtr<Request, Response> unary_call_ptr,
                    Request const&                  request,
                    ResponseCallback<Response>      on_response = nullptr,
                    StatusCallback                  on_status   = nullptr,
-                   ErrorCallback                   on_error    = nullptr) -> void;
+                   ErrorCallback                   on_error    = nullptr,
+                   CallOptions const&              options     = {}) -> SubmitResult;
+
+    /// \brief Makes a unary call from a coroutine: 'auto result = co_await client.call(...)'.
+    template <typename Response, typename Request>
+    auto call(UnaryCallPtr<Request, Response> unary_call_ptr, Request const& request, CallOptions options = {})
+        -> UnaryCallAwaitable<AsyncClient, UnaryCallPtr<Request, Response>, Request, Response>;
 
 private:
-    std::mutex            channel_mutex_;
-    grpc::CompletionQueue completion_queue_;
+    std::mutex                             channel_mutex_;
+    std::condition_variable                call_finished_;
+    std::unique_ptr<grpc::CompletionQueue> owned_completion_queue_; ///< Null if attached to an EventLoop
+    grpc::CompletionQueue*                 completion_queue_;
+
+    struct Backend {
+        std::string                             address;
+        std::uint64_t                           address_hash = 0u;
+        std::shared_ptr<grpc::Channel>          channel;
+        std::unique_ptr<typename Service::Stub> stub;
+        ClientConnectionState                   connection_state = ClientConnectionState::NoHostSpecified;
+        std::shared_ptr<detail::BackendHealth>  health           = std::make_shared<detail::BackendHealth>();
+    };
+
+    struct Method {
+        std::function<std::string(void const*)> key_extractor;
+
+        std::size_t max_outstanding_calls = 0u;
+        std::size_t outstanding_calls     = 0u;
+
+        std::optional<ResponseCache> cache            = std::nullopt;
+        std::size_t                  cache_hits       = 0u;
+        std::size_t                  cache_misses     = 0u;
+        std::uint64_t                cache_generation = 0u; ///< Bumped whenever cached responses are invalidated
+
+        bool                                                     coalesce        = false;
+        std::unordered_map<std::string, AsyncClientRpcCallData*> in_flight       = {};
+        std::size_t                                              coalesced_calls = 0u;
+    };
 
     struct Data {
         ClientTagger tagger;
+        bool         is_shutdown = false;
 
-        std::shared_ptr<grpc::Channel>          channel;
-        std::unique_ptr<typename Service::Stub> stub;
-        ClientConnectionState                   connection_state = ClientConnectionState::NoHostSpecified;
+        std::vector<std::shared_ptr<Backend>> backends;
+        // Removed backends are kept until their last state notification comes back.
+        std::vector<std::shared_ptr<Backend>> retired_backends;
+        std::size_t                           next_backend     = 0u;
+        ClientConnectionState                 connection_state = ClientConnectionState::NoHostSpecified;
+
+        std::unordered_map<std::string, Method> methods;
 
         std::unordered_map<AsyncClientRpcCallData*, std::unique_ptr<AsyncClientRpcCallData>> rpc_call_data;
 
+        std::size_t  outstanding_calls     = 0u;
+        std::size_t  max_outstanding_calls = 0u;
+        SubmitPolicy submit_policy         = SubmitPolicy::FailFast;
+        std::size_t  rejected_calls        = 0u;
+
+        std::optional<AdaptiveConcurrencyOptions> adaptive_concurrency = std::nullopt;
+        std::optional<CircuitBreakerOptions>      circuit_breaker      = std::nullopt;
+
+        util::Duration default_timeout = util::Duration::zero();
+        TimerWheel     timer_wheel;
+        grpc::Alarm    timer_alarm;
+        bool           timer_alarm_set = false;
+
         StateChangeCallback state_change_callback;
     } data_;
 
     //    util::AtomicData<Data> data_;
+
+    explicit AsyncClient(EventLoop* event_loop, std::vector<std::string> const& host_addresses);
+    explicit AsyncClient(EventLoop* event_loop, grpc::Server& interprocess_server);
+
+    auto handle_event(ClientTag const& tag, bool completed_successfully) -> void;
+    auto report_shutdown() -> void;
+    auto add_backend_locked(std::string const& host_address) -> void;
+    auto notify_on_state_change(Backend& backend, grpc_connectivity_state grpc_state) -> void;
+    auto update_connection_state() -> void;
+    auto pick_backend(Method const& method, void const* request) -> Backend*;
+    auto has_window(Method const& method) const -> bool;
+    auto has_window(Backend const& backend) const -> bool;
+    auto all_circuits_open() const -> bool;
+    auto set_timer_alarm() -> void;
+
+    template <typename Response>
+    auto complete_locally(std::string                method_key,
+                          std::string const&         serialized_response,
+                          ResponseCallback<Response> on_response,
+                          StatusCallback             on_status,
+                          ErrorCallback              on_error) -> void;
+
+    /// \brief Updates the bookkeeping for a completed call and returns it so its
+    ///        callbacks can be invoked once the lock is released.
+    auto finish_call(AsyncClientRpcCallData* call_data, bool completed_successfully)
+        -> std::unique_ptr<AsyncClientRpcCallData>;
+
+    static auto complete_call(AsyncClientRpcCallData& call_data, bool completed_successfully) -> void;
+    static auto invoke_callbacks(AsyncClientRpcCallData& call_data, bool completed_successfully) -> void;
 };
 
 namespace detail {
 
 auto to_client_connection_state(grpc_connectivity_state const& state) -> ClientConnectionState;
+auto aggregate_connection_state(std::vector<ClientConnectionState> const& states) -> ClientConnectionState;
 auto state_notification_deadline() -> std::chrono::time_point<std::chrono::system_clock>;
 
 } // namespace detail
 
 template <typename Service>
-AsyncClient<Service>::AsyncClient(std::string const& host_address) {
-    std::lock_guard channel_lock(channel_mutex_);
-    data_.channel = grpc::CreateChannel(host_address, grpc::InsecureChannelCredentials());
-    data_.stub    = Service::NewStub(data_.channel);
+AsyncClient<Service>::AsyncClient(std::string const& host_address)
+    : AsyncClient(std::vector<std::string>{host_address}) {}
+
+template <typename Service>
+AsyncClient<Service>::AsyncClient(std::vector<std::string> const& host_addresses)
+    : AsyncClient(nullptr, host_addresses) {}
+
+template <typename Service>
+AsyncClient<Service>::AsyncClient(grpc::Server& interprocess_server) : AsyncClient(nullptr, interprocess_server) {}
+
+template <typename Service>
+AsyncClient<Service>::AsyncClient(EventLoop& event_loop, std::string const& host_address)
+    : AsyncClient(&event_loop, std::vector<std::string>{host_address}) {}
+
+template <typename Service>
+AsyncClient<Service>::AsyncClient(EventLoop& event_loop, std::vector<std::string> const& host_addresses)
+    : AsyncClient(&event_loop, host_addresses) {}
 
-    auto grpc_state        = data_.channel->GetState(true);
-    data_.connection_state = detail::to_client_connection_state(grpc_state);
+template <typename Service>
+AsyncClient<Service>::AsyncClient(EventLoop& event_loop, grpc::Server& interprocess_server)
+    : AsyncClient(&event_loop, interprocess_server) {}
 
-    // Ask the channel to notify us when state changes by updating 'completion_queue'
-    data_.channel->NotifyOnStateChange(grpc_state,
-                                       detail::state_notification_deadline(),
-                                       &completion_queue_,
-                                       data_.tagger.make_tag(nullptr, ClientTagLabel::ConnectionChange));
+template <typename Service>
+AsyncClient<Service>::AsyncClient(EventLoop* event_loop, std::vector<std::string> const& host_addresses)
+    : owned_completion_queue_(event_loop ? nullptr : std::make_unique<grpc::CompletionQueue>()),
+      completion_queue_(event_loop ? &event_loop->client_queue() : owned_completion_queue_.get()) {
+    std::lock_guard channel_lock(channel_mutex_);
+    data_.tagger.set_handler([this](ClientTag const& tag, bool ok) { handle_event(tag, ok); });
+
+    for (auto const& host_address : host_addresses) {
+        add_backend_locked(host_address);
+    }
+    update_connection_state();
 }
 
 template <typename Service>
-AsyncClient<Service>::AsyncClient(grpc::Server& interprocess_server) {
+AsyncClient<Service>::AsyncClient(EventLoop* event_loop, grpc::Server& interprocess_server)
+    : owned_completion_queue_(event_loop ? nullptr : std::make_unique<grpc::CompletionQueue>()),
+      completion_queue_(event_loop ? &event_loop->client_queue() : owned_completion_queue_.get()) {
     std::lock_guard channel_lock(channel_mutex_);
-    data_.channel          = interprocess_server.InProcessChannel({});
-    data_.stub             = Service::NewStub(data_.channel);
+    data_.tagger.set_handler([this](ClientTag const& tag, bool ok) { handle_event(tag, ok); });
+
+    auto backend              = std::make_shared<Backend>();
+    backend->channel          = interprocess_server.InProcessChannel({});
+    backend->stub             = Service::NewStub(backend->channel);
+    backend->connection_state = ClientConnectionState::InterprocessServerAlwaysConnected;
+    data_.backends.emplace_back(std::move(backend));
     data_.connection_state = ClientConnectionState::InterprocessServerAlwaysConnected;
 }
 
 template <typename Service>
 auto AsyncClient<Service>::run() -> void {
+    if (!owned_completion_queue_) {
+        return; // The event loop polls the queue.
+    }
 
     void* raw_tag                = {};
     bool  completed_successfully = {};
 
-    while (completion_queue_.Next(&raw_tag, &completed_successfully)) {
-        std::lock_guard channel_lock(channel_mutex_);
+    while (completion_queue_->Next(&raw_tag, &completed_successfully)) {
+        detail::complete(raw_tag, completed_successfully);
+    }
+    report_shutdown();
+}
 
-        auto tag = data_.tagger.get_tag(raw_tag);
-        std::cout << "C: " << (completed_successfully ? "Success: " : "Failure: ") << tag << std::endl;
+template <typename Service>
+auto AsyncClient<Service>::handle_event(ClientTag const& tag, bool completed_successfully) -> void {
+    std::unique_lock channel_lock(channel_mutex_);
+
+    std::cout << "C: " << (completed_successfully ? "Success: " : "Failure: ") << tag << std::endl;
+
+    switch (tag.label) {
+
+    case ClientTagLabel::ConnectionChange: {
+        auto* backend = static_cast<Backend*>(tag.data);
+
+        auto is_backend = [backend](auto const& b) { return b.get() == backend; };
+
+        auto retired = std::find_if(data_.retired_backends.begin(), data_.retired_backends.end(), is_backend);
+        if (retired != data_.retired_backends.end()) {
+            data_.retired_backends.erase(retired);
+            break;
+        }
+
+        if (completed_successfully && backend->channel) {
+            auto grpc_state           = backend->channel->GetState(true);
+            backend->connection_state = detail::to_client_connection_state(grpc_state);
+
+            update_connection_state();
+            notify_on_state_change(*backend, grpc_state);
+        }
+
+    } break;
+
+    case ClientTagLabel::UnaryFinished: {
+        auto* raw_call_data = static_cast<AsyncClientRpcCallData*>(tag.data);
+        if (raw_call_data->alarm) {
+            // Calls answered from the cache wake the queue by cancelling their alarm so the
+            // event itself always fails. They always succeed.
+            completed_successfully = true;
+        }
+
+        auto call_data = finish_call(raw_call_data, completed_successfully);
+
+        // Callbacks are invoked without the lock held so they can make more calls.
+        channel_lock.unlock();
+        complete_call(*call_data, completed_successfully);
+    } break;
+
+    case ClientTagLabel::TimerTick: {
+        data_.timer_alarm_set = false;
+        if (completed_successfully) {
+            // Expired calls are cancelled and report the timeout when their Finish tag comes back.
+            data_.timer_wheel.advance(TimerWheel::Clock::now(), [](void* data) {
+                auto call_data       = static_cast<AsyncClientRpcCallData*>(data);
+                call_data->timer_id  = 0u;
+                call_data->timed_out = true;
+                call_data->context.TryCancel();
+            });
+            set_timer_alarm();
+        }
+    } break;
+
+    } // end switch
+}
 
-        switch (tag.label) {
+template <typename Service>
+auto AsyncClient<Service>::report_shutdown() -> void {
+    data_.connection_state = ClientConnectionState::NoHostSpecified;
+    if (data_.state_change_callback) {
+        data_.state_change_callback(data_.connection_state);
+    }
+}
 
-        case ClientTagLabel::ConnectionChange: {
-            if (completed_successfully && data_.channel) {
-                auto grpc_state = data_.channel->GetState(true);
-                auto state      = detail::to_client_connection_state(grpc_state);
+template <typename Service>
+auto AsyncClient<Service>::shutdown() -> void {
+    {
+        std::lock_guard channel_lock(channel_mutex_);
+        for (const auto& rpc_key_and_data : data_.rpc_call_data) {
+            rpc_key_and_data.second->context.TryCancel();
+        }
+        data_.is_shutdown = true;
+        data_.timer_alarm.Cancel();
+        if (owned_completion_queue_) {
+            owned_completion_queue_->Shutdown();
+        }
+        // Releasing the channels also wakes up the pending state notifications.
+        for (auto& backend : data_.backends) {
+            backend->stub    = nullptr;
+            backend->channel = nullptr;
+        }
+        call_finished_.notify_all();
+    }
 
-                if (data_.connection_state != state && data_.state_change_callback) {
-                    data_.state_change_callback(state);
-                }
-                data_.connection_state = state;
+    if (!owned_completion_queue_) {
+        // The shared queues aren't shut down so wait for this client's operations to come back.
+        data_.tagger.wait_for_outstanding_tags();
+        report_shutdown();
+    }
+}
 
-                // Ask the channel to notify us when state changes by updating 'completion_queue_'
-                data_.channel->NotifyOnStateChange(grpc_state,
-                                                   detail::state_notification_deadline(),
-                                                   &completion_queue_,
-                                                   data_.tagger.make_tag(nullptr, ClientTagLabel::ConnectionChange));
-            }
+template <typename Service>
+auto AsyncClient<Service>::on_state_change(StateChangeCallback callback, CallImmediately call_immediately)
+    -> AsyncClient& {
+    std::lock_guard channel_lock(channel_mutex_);
+    data_.state_change_callback = callback;
+    if (call_immediately == CallImmediately::Yes) {
+        data_.state_change_callback(data_.connection_state);
+    }
+    return *this;
+}
 
-        } break;
+template <typename Service>
+auto AsyncClient<Service>::set_default_timeout(util::Duration timeout) -> AsyncClient& {
+    std::lock_guard channel_lock(channel_mutex_);
+    data_.default_timeout = timeout;
+    return *this;
+}
 
-        case ClientTagLabel::UnaryFinished: {
-            auto call_data = static_cast<AsyncClientRpcCallData*>(tag.data);
-            if (completed_successfully) {
-                call_data->process_callbacks();
-                if (call_data->status_callback) {
-                    call_data->status_callback(call_data->status);
-                }
-            } else {
-                if (call_data->error_callback) {
-                    call_data->error_callback(LTB_MAKE_ERROR("Rpc could not complete."));
-                }
-            }
-            data_.rpc_call_data.erase(call_data);
-        } break;
+template <typename Service>
+auto AsyncClient<Service>::set_max_outstanding_calls(std::size_t limit, SubmitPolicy policy) -> AsyncClient& {
+    {
+        std::lock_guard channel_lock(channel_mutex_);
+        data_.max_outstanding_calls = limit;
+        data_.submit_policy         = policy;
+    }
+    call_finished_.notify_all();
+    return *this;
+}
 
-        } // end switch
+template <typename Service>
+template <typename Response, typename Request>
+auto AsyncClient<Service>::set_max_outstanding_calls(UnaryCallPtr<Request, Response> unary_call_ptr,
+                                                     std::size_t                     limit) -> AsyncClient& {
+    {
+        std::lock_guard channel_lock(channel_mutex_);
+        data_.methods[detail::method_key(unary_call_ptr)].max_outstanding_calls = limit;
     }
+    call_finished_.notify_all();
+    return *this;
+}
 
-    data_.connection_state = ClientConnectionState::NoHostSpecified;
-    if (data_.state_change_callback) {
-        data_.state_change_callback(data_.connection_state);
+template <typename Service>
+auto AsyncClient<Service>::enable_adaptive_concurrency(AdaptiveConcurrencyOptions options) -> AsyncClient& {
+    {
+        std::lock_guard channel_lock(channel_mutex_);
+        data_.adaptive_concurrency = options;
+        for (auto& backend : data_.backends) {
+            backend->health->concurrency_limit.emplace(options);
+        }
     }
+    call_finished_.notify_all();
+    return *this;
 }
 
 template <typename Service>
-auto AsyncClient<Service>::shutdown() -> void {
+auto AsyncClient<Service>::enable_circuit_breaker(CircuitBreakerOptions options) -> AsyncClient& {
+    {
+        std::lock_guard channel_lock(channel_mutex_);
+        data_.circuit_breaker = options;
+        for (auto& backend : data_.backends) {
+            backend->health->circuit_breaker.emplace(options);
+        }
+    }
+    call_finished_.notify_all();
+    return *this;
+}
+
+template <typename Service>
+template <typename Response, typename Request>
+auto AsyncClient<Service>::enable_response_cache(UnaryCallPtr<Request, Response> unary_call_ptr,
+                                                 ResponseCacheOptions            options) -> AsyncClient& {
     std::lock_guard channel_lock(channel_mutex_);
-    for (const auto& rpc_key_and_data : data_.rpc_call_data) {
-        rpc_key_and_data.second->context.TryCancel();
+    data_.methods[detail::method_key(unary_call_ptr)].cache.emplace(options);
+    return *this;
+}
+
+template <typename Service>
+template <typename Response, typename Request>
+auto AsyncClient<Service>::enable_request_coalescing(UnaryCallPtr<Request, Response> unary_call_ptr) -> AsyncClient& {
+    std::lock_guard channel_lock(channel_mutex_);
+    data_.methods[detail::method_key(unary_call_ptr)].coalesce = true;
+    return *this;
+}
+
+template <typename Service>
+template <typename Response, typename Request>
+auto AsyncClient<Service>::invalidate_cached_response(UnaryCallPtr<Request, Response> unary_call_ptr,
+                                                      Request const&                  request) -> AsyncClient& {
+    std::lock_guard channel_lock(channel_mutex_);
+    auto&           method = data_.methods[detail::method_key(unary_call_ptr)];
+    if (method.cache) {
+        auto request_key = request.SerializeAsString();
+        method.cache->erase(request_key);
+        method.in_flight.erase(request_key);
+        ++method.cache_generation;
     }
-    completion_queue_.Shutdown();
-    data_.stub    = nullptr;
-    data_.channel = nullptr;
+    return *this;
 }
 
 template <typename Service>
-auto AsyncClient<Service>::on_state_change(StateChangeCallback callback, CallImmediately call_immediately)
+template <typename Response, typename Request>
+auto AsyncClient<Service>::invalidate_cached_responses(UnaryCallPtr<Request, Response> unary_call_ptr)
     -> AsyncClient& {
     std::lock_guard channel_lock(channel_mutex_);
-    data_.state_change_callback = callback;
-    if (call_immediately == CallImmediately::Yes) {
-        data_.state_change_callback(data_.connection_state);
+    auto&           method = data_.methods[detail::method_key(unary_call_ptr)];
+    if (method.cache) {
+        method.cache->clear();
+        method.in_flight.clear();
+        ++method.cache_generation;
+    }
+    return *this;
+}
+
+template <typename Service>
+auto AsyncClient<Service>::stats() -> AsyncClientStats {
+    std::lock_guard channel_lock(channel_mutex_);
+    AsyncClientStats stats;
+    stats.outstanding_calls     = data_.outstanding_calls;
+    stats.max_outstanding_calls = data_.max_outstanding_calls;
+    stats.rejected_calls        = data_.rejected_calls;
+
+    for (auto const& key_and_method : data_.methods) {
+        stats.cache_hits += key_and_method.second.cache_hits;
+        stats.cache_misses += key_and_method.second.cache_misses;
+        stats.coalesced_calls += key_and_method.second.coalesced_calls;
+    }
+
+    for (auto const& backend : data_.backends) {
+        BackendStats backend_stats;
+        backend_stats.address           = backend->address;
+        backend_stats.connection_state  = backend->connection_state;
+        backend_stats.outstanding_calls = backend->health->outstanding_calls;
+        if (backend->health->concurrency_limit) {
+            backend_stats.concurrency_limit = backend->health->concurrency_limit->limit();
+        }
+        if (backend->health->circuit_breaker) {
+            backend_stats.circuit_state = backend->health->circuit_breaker->state(CircuitBreaker::Clock::now());
+        }
+        stats.backends.emplace_back(std::move(backend_stats));
+    }
+    return stats;
+}
+
+template <typename Service>
+template <typename Response, typename Request>
+auto AsyncClient<Service>::outstanding_calls(UnaryCallPtr<Request, Response> unary_call_ptr) -> std::size_t {
+    std::lock_guard channel_lock(channel_mutex_);
+    return data_.methods[detail::method_key(unary_call_ptr)].outstanding_calls;
+}
+
+template <typename Service>
+auto AsyncClient<Service>::add_backend(std::string const& host_address) -> AsyncClient& {
+    std::lock_guard channel_lock(channel_mutex_);
+    add_backend_locked(host_address);
+    update_connection_state();
+    return *this;
+}
+
+template <typename Service>
+auto AsyncClient<Service>::remove_backend(std::string const& host_address) -> AsyncClient& {
+    std::lock_guard channel_lock(channel_mutex_);
+
+    auto is_address = [&host_address](auto const& backend) { return backend->address == host_address; };
+
+    auto iter = std::find_if(data_.backends.begin(), data_.backends.end(), is_address);
+    if (iter != data_.backends.end()) {
+        // Releasing the channel wakes up the pending state notification.
+        (*iter)->stub    = nullptr;
+        (*iter)->channel = nullptr;
+        data_.retired_backends.emplace_back(std::move(*iter));
+        data_.backends.erase(iter);
+        update_connection_state();
+    }
+    return *this;
+}
+
+template <typename Service>
+template <typename Response, typename Request>
+auto AsyncClient<Service>::route_by_key(UnaryCallPtr<Request, Response> unary_call_ptr,
+                                        KeyExtractor<Request>           key_extractor) -> AsyncClient& {
+    std::lock_guard channel_lock(channel_mutex_);
+    auto&           method = data_.methods[detail::method_key(unary_call_ptr)];
+    if (key_extractor) {
+        method.key_extractor = [key_extractor = std::move(key_extractor)](void const* request) {
+            return key_extractor(*static_cast<Request const*>(request));
+        };
+    } else {
+        method.key_extractor = nullptr;
     }
     return *this;
 }
@@ -199,24 +616,365 @@ auto AsyncClient<Service>::unary_rpc(UnaryCallPtr<Request, Response> unary_call_
                                      Request const&                  request,
                                      ResponseCallback<Response>      on_response,
                                      StatusCallback                  on_status,
-                                     ErrorCallback                   on_error) -> void {
-    std::lock_guard channel_lock(channel_mutex_);
+                                     ErrorCallback                   on_error,
+                                     CallOptions const&              options) -> SubmitResult {
+    {
+        std::unique_lock channel_lock(channel_mutex_);
+
+        auto  method_key = detail::method_key(unary_call_ptr);
+        auto& method     = data_.methods[method_key];
+
+        std::optional<std::string> request_key = std::nullopt;
+        if ((method.cache || method.coalesce) && !data_.is_shutdown) {
+            request_key = request.SerializeAsString();
+        }
+
+        if (method.cache && request_key) {
+            if (auto const* cached = method.cache->find(*request_key, ResponseCache::Clock::now())) {
+                ++method.cache_hits;
+                complete_locally<Response>(std::move(method_key), *cached, on_response, on_status, on_error);
+                return SubmitResult::Submitted;
+            }
+            ++method.cache_misses;
+        }
+
+        if (method.coalesce && request_key) {
+            auto in_flight_iter = method.in_flight.find(*request_key);
+            if (in_flight_iter != method.in_flight.end()) {
+                auto waiter               = std::make_unique<AsyncClientUnaryCallData<Response>>();
+                waiter->method_key        = std::move(method_key);
+                waiter->response_callback = std::move(on_response);
+                waiter->status_callback   = std::move(on_status);
+                waiter->error_callback    = std::move(on_error);
+
+                in_flight_iter->second->waiters.emplace_back(std::move(waiter));
+                ++method.coalesced_calls;
+                return SubmitResult::Submitted;
+            }
+        }
+
+        Backend* backend   = nullptr;
+        auto     available = [this, &method, &request, &backend] {
+            backend = (has_window(method) ? pick_backend(method, &request) : nullptr);
+            return backend != nullptr;
+        };
+
+        // Nothing marks an open circuit turning half-open, so callers are rejected instead of
+        // waiting for a call to finish that may never be sent.
+        auto circuits_open = [this, &backend] { return !backend && all_circuits_open(); };
+
+        if (!available() && !circuits_open() && !data_.is_shutdown && !data_.backends.empty()) {
+            switch (options.submit_policy.value_or(data_.submit_policy)) {
+            case SubmitPolicy::Block:
+                call_finished_.wait(channel_lock, [this, &available, &circuits_open] {
+                    return data_.is_shutdown || available() || circuits_open();
+                });
+                break;
+
+            case SubmitPolicy::FailFast:
+                ++data_.rejected_calls;
+                channel_lock.unlock();
+                if (on_error) {
+                    on_error(LTB_MAKE_ERROR("Too many outstanding calls."));
+                }
+                return SubmitResult::Rejected;
+
+            case SubmitPolicy::TryLater:
+                ++data_.rejected_calls;
+                return SubmitResult::TryLater;
+            }
+        }
+
+        if (circuits_open()) {
+            ++data_.rejected_calls;
+            channel_lock.unlock();
+            if (on_error) {
+                on_error(LTB_MAKE_ERROR("Circuit breaker open."));
+            }
+            return SubmitResult::Rejected;
+        }
+
+        if (backend) {
+            auto unary_call_data     = std::make_unique<AsyncClientUnaryCallData<Response>>();
+            auto raw_unary_call_data = unary_call_data.get();
+
+            unary_call_data->method_key        = std::move(method_key);
+            unary_call_data->backend_health    = backend->health;
+            unary_call_data->start_time        = TimerWheel::Clock::now();
+            unary_call_data->request_key       = request_key;
+            unary_call_data->cache_generation  = method.cache_generation;
+            unary_call_data->response_callback = on_response;
+            unary_call_data->status_callback   = on_status;
+            unary_call_data->error_callback    = on_error;
+
+            auto timeout = options.timeout.value_or(data_.default_timeout);
+            if (timeout > util::Duration::zero()) {
+                // The deadline is propagated to the server while the timer wheel
+                // guarantees the call is expired on the client.
+                unary_call_data->context.set_deadline(std::chrono::system_clock::now() + timeout);
+                auto now                  = TimerWheel::Clock::now();
+                unary_call_data->timer_id = data_.timer_wheel.schedule(now + timeout, raw_unary_call_data, now);
+                set_timer_alarm();
+            }
+
+            unary_call_data->response_reader
+                = ((backend->stub.get())->*unary_call_ptr)(&unary_call_data->context, request, completion_queue_);
+
+            unary_call_data->response_reader->Finish(&unary_call_data->response,
+                                                     &unary_call_data->status,
+                                                     data_.tagger.make_tag(raw_unary_call_data,
+                                                                           ClientTagLabel::UnaryFinished));
+
+            if (method.coalesce && request_key) {
+                method.in_flight.emplace(std::move(*request_key), raw_unary_call_data);
+            }
+            data_.rpc_call_data.emplace(raw_unary_call_data, std::move(unary_call_data));
+            ++data_.outstanding_calls;
+            ++method.outstanding_calls;
+            ++backend->health->outstanding_calls;
+            if (backend->health->circuit_breaker) {
+                raw_unary_call_data->circuit_generation
+                    = backend->health->circuit_breaker->on_send(raw_unary_call_data->start_time);
+            }
+            return SubmitResult::Submitted;
+        }
+    }
+
+    // Called without the lock held so the callback can make more calls.
+    if (on_error) {
+        on_error(LTB_MAKE_ERROR("No backends available."));
+    }
+    return SubmitResult::Rejected;
+}
+
+template <typename Service>
+template <typename Response, typename Request>
+auto AsyncClient<Service>::call(UnaryCallPtr<Request, Response> unary_call_ptr,
+                                Request const&                  request,
+                                CallOptions                     options)
+    -> UnaryCallAwaitable<AsyncClient, UnaryCallPtr<Request, Response>, Request, Response> {
+    return UnaryCallAwaitable<AsyncClient, UnaryCallPtr<Request, Response>, Request, Response>(*this,
+                                                                                              unary_call_ptr,
+                                                                                              request,
+                                                                                              std::move(options));
+}
 
+template <typename Service>
+auto AsyncClient<Service>::add_backend_locked(std::string const& host_address) -> void {
+    auto backend          = std::make_shared<Backend>();
+    backend->address      = host_address;
+    backend->address_hash = stable_hash(host_address);
+    if (data_.adaptive_concurrency) {
+        backend->health->concurrency_limit.emplace(*data_.adaptive_concurrency);
+    }
+    if (data_.circuit_breaker) {
+        backend->health->circuit_breaker.emplace(*data_.circuit_breaker);
+    }
+    backend->channel      = grpc::CreateChannel(host_address, grpc::InsecureChannelCredentials());
+    backend->stub         = Service::NewStub(backend->channel);
+
+    auto grpc_state           = backend->channel->GetState(true);
+    backend->connection_state = detail::to_client_connection_state(grpc_state);
+
+    notify_on_state_change(*backend, grpc_state);
+    data_.backends.emplace_back(std::move(backend));
+}
+
+template <typename Service>
+auto AsyncClient<Service>::notify_on_state_change(Backend& backend, grpc_connectivity_state grpc_state) -> void {
+    // Ask the channel to notify us when state changes by updating 'completion_queue_'
+    backend.channel->NotifyOnStateChange(grpc_state,
+                                         detail::state_notification_deadline(),
+                                         completion_queue_,
+                                         data_.tagger.make_tag(&backend, ClientTagLabel::ConnectionChange));
+}
+
+template <typename Service>
+auto AsyncClient<Service>::update_connection_state() -> void {
+    std::vector<ClientConnectionState> states;
+    states.reserve(data_.backends.size());
+    for (auto const& backend : data_.backends) {
+        states.emplace_back(backend->connection_state);
+    }
+    auto state = detail::aggregate_connection_state(states);
+
+    if (data_.connection_state != state && data_.state_change_callback) {
+        data_.state_change_callback(state);
+    }
+    data_.connection_state = state;
+}
+
+template <typename Service>
+auto AsyncClient<Service>::pick_backend(Method const& method, void const* request) -> Backend* {
+    if (data_.is_shutdown || data_.backends.empty()) {
+        return nullptr;
+    }
+
+    if (!method.key_extractor) {
+        for (auto i = 0u; i < data_.backends.size(); ++i) {
+            auto& backend = data_.backends[data_.next_backend++ % data_.backends.size()];
+            if (has_window(*backend)) {
+                return backend.get();
+            }
+        }
+        return nullptr;
+    }
+
+    // Backends at their limit or with an open circuit are skipped so their keys spill over.
+    auto const& backends = data_.backends;
+    auto        best     = pick_rendezvous(backends.size(),
+                                           stable_hash(method.key_extractor(request)),
+                                           [&backends](std::size_t i) { return backends[i]->address_hash; },
+                                           [this, &backends](std::size_t i) { return has_window(*backends[i]); });
+
+    return (best < backends.size() ? backends[best].get() : nullptr);
+}
+
+template <typename Service>
+auto AsyncClient<Service>::has_window(Method const& method) const -> bool {
+    return (data_.max_outstanding_calls == 0u || data_.outstanding_calls < data_.max_outstanding_calls)
+        && (method.max_outstanding_calls == 0u || method.outstanding_calls < method.max_outstanding_calls);
+}
+
+template <typename Service>
+auto AsyncClient<Service>::has_window(Backend const& backend) const -> bool {
+    auto const& health = *backend.health;
+    if (health.circuit_breaker && !health.circuit_breaker->can_send(CircuitBreaker::Clock::now())) {
+        return false;
+    }
+    return !health.concurrency_limit || health.outstanding_calls < health.concurrency_limit->limit();
+}
+
+template <typename Service>
+auto AsyncClient<Service>::all_circuits_open() const -> bool {
+    auto now = CircuitBreaker::Clock::now();
+    return !data_.backends.empty()
+        && std::all_of(data_.backends.begin(), data_.backends.end(), [now](auto const& backend) {
+               auto const& breaker = backend->health->circuit_breaker;
+               return breaker && !breaker->can_send(now);
+           });
+}
+
+template <typename Service>
+auto AsyncClient<Service>::set_timer_alarm() -> void {
+    if (!data_.timer_alarm_set && !data_.timer_wheel.empty()) {
+        data_.timer_alarm.Set(completion_queue_,
+                              std::chrono::system_clock::now() + data_.timer_wheel.resolution(),
+                              data_.tagger.make_tag(nullptr, ClientTagLabel::TimerTick));
+        data_.timer_alarm_set = true;
+    }
+}
+
+template <typename Service>
+template <typename Response>
+auto AsyncClient<Service>::complete_locally(std::string                method_key,
+                                            std::string const&         serialized_response,
+                                            ResponseCallback<Response> on_response,
+                                            StatusCallback             on_status,
+                                            ErrorCallback              on_error) -> void {
     auto unary_call_data     = std::make_unique<AsyncClientUnaryCallData<Response>>();
     auto raw_unary_call_data = unary_call_data.get();
 
-    unary_call_data->response_callback = on_response;
-    unary_call_data->status_callback   = on_status;
-    unary_call_data->error_callback    = on_error;
+    unary_call_data->method_key        = std::move(method_key);
+    unary_call_data->response_callback = std::move(on_response);
+    unary_call_data->status_callback   = std::move(on_status);
+    unary_call_data->error_callback    = std::move(on_error);
+    unary_call_data->status            = grpc::Status::OK;
+    unary_call_data->response.ParseFromString(serialized_response);
+
+    // Callbacks are always invoked from the completion queue thread. Cancelling an alarm that
+    // never expires queues its tag right away instead of going through gRPC's timer thread.
+    unary_call_data->alarm = std::make_unique<grpc::Alarm>();
+    unary_call_data->alarm->Set(completion_queue_,
+                                gpr_inf_future(GPR_CLOCK_MONOTONIC),
+                                data_.tagger.make_tag(raw_unary_call_data, ClientTagLabel::UnaryFinished));
+    unary_call_data->alarm->Cancel();
 
-    unary_call_data->response_reader
-        = ((data_.stub.get())->*unary_call_ptr)(&unary_call_data->context, request, &completion_queue_);
+    data_.rpc_call_data.emplace(raw_unary_call_data, std::move(unary_call_data));
+}
 
-    unary_call_data->response_reader->Finish(&unary_call_data->response,
-                                             &unary_call_data->status,
-                                             data_.tagger.make_tag(raw_unary_call_data, ClientTagLabel::UnaryFinished));
+template <typename Service>
+auto AsyncClient<Service>::finish_call(AsyncClientRpcCallData* call_data, bool completed_successfully)
+    -> std::unique_ptr<AsyncClientRpcCallData> {
+    if (call_data->timer_id != 0u) {
+        data_.timer_wheel.cancel(call_data->timer_id);
+    }
 
-    data_.rpc_call_data.emplace(raw_unary_call_data, std::move(unary_call_data));
+    auto& method = data_.methods[call_data->method_key];
+
+    if (call_data->request_key) {
+        auto in_flight_iter = method.in_flight.find(*call_data->request_key);
+        if (in_flight_iter != method.in_flight.end() && in_flight_iter->second == call_data) {
+            method.in_flight.erase(in_flight_iter);
+        }
+    }
+
+    if (call_data->backend_health) {
+        auto& health = *call_data->backend_health;
+        auto  failed = detail::is_backend_failure(call_data->status, completed_successfully, call_data->timed_out);
+        auto  now    = TimerWheel::Clock::now();
+
+        if (health.concurrency_limit) {
+            health.concurrency_limit->on_sample(now - call_data->start_time, health.outstanding_calls, failed);
+        }
+        if (health.circuit_breaker) {
+            if (failed) {
+                health.circuit_breaker->on_failure(call_data->circuit_generation, now);
+            } else {
+                health.circuit_breaker->on_success(call_data->circuit_generation);
+            }
+        }
+        --health.outstanding_calls;
+        --method.outstanding_calls;
+        --data_.outstanding_calls;
+
+        // Calls sent before an invalidation may carry the stale response, so they don't put it back.
+        if (method.cache && call_data->request_key && call_data->cache_generation == method.cache_generation
+            && completed_successfully && call_data->status.ok()) {
+            method.cache->insert(std::move(*call_data->request_key), call_data->serialized_response(), now);
+        }
+    }
+
+    auto call_iter = data_.rpc_call_data.find(call_data);
+    auto finished  = std::move(call_iter->second);
+    data_.rpc_call_data.erase(call_iter);
+
+    call_finished_.notify_all();
+    return finished;
+}
+
+template <typename Service>
+auto AsyncClient<Service>::complete_call(AsyncClientRpcCallData& call_data, bool completed_successfully) -> void {
+    invoke_callbacks(call_data, completed_successfully);
+
+    for (auto& waiter : call_data.waiters) {
+        waiter->status    = call_data.status;
+        waiter->timed_out = call_data.timed_out;
+        if (completed_successfully) {
+            call_data.share_response(*waiter);
+        }
+        invoke_callbacks(*waiter, completed_successfully);
+    }
+}
+
+template <typename Service>
+auto AsyncClient<Service>::invoke_callbacks(AsyncClientRpcCallData& call_data, bool completed_successfully) -> void {
+    if (call_data.timed_out || call_data.status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED) {
+        if (call_data.error_callback) {
+            call_data.error_callback(LTB_MAKE_ERROR("Rpc timed out."));
+        }
+
+    } else if (completed_successfully) {
+        call_data.process_callbacks();
+        if (call_data.status_callback) {
+            call_data.status_callback(call_data.status);
+        }
+
+    } else {
+        if (call_data.error_callback) {
+            call_data.error_callback(LTB_MAKE_ERROR("Rpc could not complete."));
+        }
+    }
 }
 
 } // namespace ltb::net
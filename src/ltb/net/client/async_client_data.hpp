@@ -23,13 +23,23 @@
 #pragma once
 
 // project
+#include "ltb/net/client/adaptive_concurrency_limit.hpp"
+#include "ltb/net/client/circuit_breaker.hpp"
+#include "ltb/net/client/timer_wheel.hpp"
+#include "ltb/net/response_cache.hpp"
+#include "ltb/util/duration.hpp"
 #include "ltb/util/error.hpp"
 
 // external
+#include <grpc++/alarm.h>
 #include <grpc++/client_context.h>
 
 // standard
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
 
 namespace ltb::net {
 
@@ -53,10 +63,73 @@ using ErrorCallback  = std::function<void(ltb::util::Error)>;
 template <typename Response>
 using ResponseCallback = std::function<void(Response)>;
 
+/// \brief What happens to a new call when the outstanding call limit has been reached.
+enum class SubmitPolicy {
+    Block, ///< Wait for an outstanding call to finish. Never use from a client callback.
+    FailFast, ///< Reject the call and invoke its ErrorCallback.
+    TryLater, ///< Reject the call without invoking any callbacks.
+};
+
+enum class SubmitResult {
+    Submitted,
+    Rejected,
+    TryLater,
+};
+
+struct CallOptions {
+    /// \brief Overrides the client's default timeout. A zero timeout means the call never times out.
+    std::optional<util::Duration> timeout = std::nullopt;
+
+    /// \brief Overrides the client's default submit policy.
+    std::optional<SubmitPolicy> submit_policy = std::nullopt;
+};
+
+struct BackendStats {
+    std::string           address;
+    ClientConnectionState connection_state  = ClientConnectionState::NoHostSpecified;
+    std::size_t           outstanding_calls = 0u;
+    std::size_t           concurrency_limit = 0u; ///< Zero if adaptive concurrency is disabled.
+    CircuitState          circuit_state     = CircuitState::Closed;
+};
+
+struct AsyncClientStats {
+    std::size_t outstanding_calls     = 0u;
+    std::size_t max_outstanding_calls = 0u; ///< Zero if there is no limit.
+    std::size_t rejected_calls        = 0u;
+
+    std::size_t cache_hits      = 0u;
+    std::size_t cache_misses    = 0u;
+    std::size_t coalesced_calls = 0u;
+
+    std::vector<BackendStats> backends;
+};
+
+namespace detail {
+
+template <typename T>
+struct NonDeduced {
+    using type = T;
+};
+
+// Shared with the calls sent to a backend so they can report back
+// even if the backend is removed while they are in flight.
+struct BackendHealth {
+    std::size_t                             outstanding_calls = 0u;
+    std::optional<AdaptiveConcurrencyLimit> concurrency_limit = std::nullopt;
+    std::optional<CircuitBreaker>           circuit_breaker   = std::nullopt;
+};
+
+/// \brief Whether a finished call suggests the backend is overloaded or failing.
+auto is_backend_failure(grpc::Status const& status, bool completed_successfully, bool timed_out) -> bool;
+
+} // namespace detail
+
 struct AsyncClientRpcCallData {
     virtual ~AsyncClientRpcCallData() = default;
 
-    virtual auto process_callbacks() -> void = 0;
+    virtual auto process_callbacks() -> void                                  = 0;
+    virtual auto serialized_response() const -> std::string                   = 0;
+    virtual auto share_response(AsyncClientRpcCallData& waiter) const -> void = 0;
 
     // Context for the client. It could be used to convey extra information to
     // the server and/or tweak certain RPC behaviors.
@@ -65,8 +138,32 @@ struct AsyncClientRpcCallData {
     // Storage for the status of the RPC upon completion.
     grpc::Status status;
 
+    // Identifies the method's settings and limits.
+    std::string method_key;
+
+    // Null if the call was completed locally without being sent to a backend.
+    std::shared_ptr<detail::BackendHealth> backend_health     = nullptr;
+    TimerWheel::Clock::time_point          start_time         = {};
+    CircuitBreaker::Generation             circuit_generation = 0u; ///< When the backend's breaker sent the call
+
+    // Used to complete calls answered from the cache on the completion queue.
+    std::unique_ptr<grpc::Alarm> alarm = nullptr;
+
+    // The serialized request if the method caches or coalesces responses.
+    std::optional<std::string> request_key = std::nullopt;
+
+    // The method's cache generation when the call was sent (see invalidate_cached_responses()).
+    std::uint64_t cache_generation = 0u;
+
+    // Identical calls that joined this one and complete with its result.
+    std::vector<std::unique_ptr<AsyncClientRpcCallData>> waiters = {};
+
     StatusCallback status_callback = nullptr;
     ErrorCallback  error_callback  = nullptr;
+
+    // Client-side expiry of the call. Zero if the call has no timeout.
+    TimerWheel::TimerId timer_id  = 0u;
+    bool                timed_out = false;
 };
 
 template <typename Response>
@@ -74,6 +171,8 @@ struct AsyncClientUnaryCallData : public AsyncClientRpcCallData {
     ~AsyncClientUnaryCallData() override = default;
 
     auto process_callbacks() -> void override;
+    auto serialized_response() const -> std::string override;
+    auto share_response(AsyncClientRpcCallData& waiter) const -> void override;
 
     Response response = {};
 
@@ -89,4 +188,15 @@ auto AsyncClientUnaryCallData<Response>::process_callbacks() -> void {
     }
 }
 
+template <typename Response>
+auto AsyncClientUnaryCallData<Response>::serialized_response() const -> std::string {
+    return response.SerializeAsString();
+}
+
+template <typename Response>
+auto AsyncClientUnaryCallData<Response>::share_response(AsyncClientRpcCallData& waiter) const -> void {
+    // Waiters are always created for the same method as the call they join.
+    static_cast<AsyncClientUnaryCallData<Response>&>(waiter).response = response;
+}
+
 } // namespace ltb::net
@@ -0,0 +1,250 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "circuit_breaker.hpp"
+
+// external
+#include <doctest/doctest.h>
+
+namespace ltb::net {
+
+CircuitBreaker::CircuitBreaker(CircuitBreakerOptions options) : options_(options) {
+    window_.reserve(options_.window_size);
+}
+
+auto CircuitBreaker::can_send(Clock::time_point now) const -> bool {
+    switch (state(now)) {
+    case CircuitState::Closed:
+        return true;
+    case CircuitState::Open:
+        return false;
+    case CircuitState::HalfOpen:
+        return probes_in_flight_ < options_.half_open_probes;
+    }
+    return false;
+}
+
+auto CircuitBreaker::on_send(Clock::time_point now) -> Generation {
+    if (state(now) == CircuitState::HalfOpen) {
+        if (state_ != CircuitState::HalfOpen) {
+            state_ = CircuitState::HalfOpen;
+            ++generation_;
+        }
+        ++probes_in_flight_;
+    }
+    return generation_;
+}
+
+auto CircuitBreaker::on_success(Generation sent_in) -> void {
+    if (sent_in != generation_) {
+        return;
+    }
+    if (state_ == CircuitState::HalfOpen) {
+        if (probes_in_flight_ > 0u) {
+            --probes_in_flight_;
+        }
+        if (++probe_successes_ >= options_.half_open_probes) {
+            close();
+        }
+        return;
+    }
+    record(false);
+}
+
+auto CircuitBreaker::on_failure(Generation sent_in, Clock::time_point now) -> void {
+    if (sent_in != generation_) {
+        return;
+    }
+    if (state_ == CircuitState::HalfOpen) {
+        open(now);
+        return;
+    }
+    if (state_ == CircuitState::Closed) {
+        record(true);
+
+        auto failure_rate = static_cast<double>(window_failures_) / static_cast<double>(window_.size());
+
+        auto too_many_in_a_row
+            = options_.consecutive_failures > 0u && consecutive_failures_ >= options_.consecutive_failures;
+        auto too_many_in_window
+            = !window_.empty() && window_.size() >= options_.minimum_calls && failure_rate >= options_.failure_rate;
+
+        if (too_many_in_a_row || too_many_in_window) {
+            open(now);
+        }
+    }
+}
+
+auto CircuitBreaker::state(Clock::time_point now) const -> CircuitState {
+    if (state_ == CircuitState::Open && now - opened_at_ >= options_.open_duration) {
+        return CircuitState::HalfOpen;
+    }
+    return state_;
+}
+
+auto CircuitBreaker::record(bool failed) -> void {
+    consecutive_failures_ = (failed ? consecutive_failures_ + 1u : 0u);
+
+    if (options_.window_size == 0u) {
+        return;
+    }
+    if (window_.size() < options_.window_size) {
+        window_.push_back(failed);
+    } else {
+        window_failures_ -= (window_[window_index_] ? 1u : 0u);
+        window_[window_index_] = failed;
+        window_index_          = (window_index_ + 1u) % options_.window_size;
+    }
+    window_failures_ += (failed ? 1u : 0u);
+}
+
+auto CircuitBreaker::open(Clock::time_point now) -> void {
+    ++generation_;
+    state_            = CircuitState::Open;
+    opened_at_        = now;
+    probes_in_flight_ = 0u;
+    probe_successes_  = 0u;
+}
+
+auto CircuitBreaker::close() -> void {
+    ++generation_;
+    state_                = CircuitState::Closed;
+    probes_in_flight_     = 0u;
+    probe_successes_      = 0u;
+    consecutive_failures_ = 0u;
+    window_failures_      = 0u;
+    window_index_         = 0u;
+    window_.clear();
+}
+
+TEST_CASE("[ltb][net] circuit_breaker opens on failures and closes after a successful probe") {
+    using namespace std::chrono_literals;
+
+    CircuitBreakerOptions options;
+    options.consecutive_failures = 3u;
+    options.open_duration        = 1s;
+
+    auto           now = CircuitBreaker::Clock::time_point{};
+    CircuitBreaker breaker(options);
+
+    CHECK(breaker.state(now) == CircuitState::Closed);
+
+    for (auto i = 0; i < 3; ++i) {
+        CHECK(breaker.can_send(now));
+        breaker.on_failure(breaker.on_send(now), now);
+    }
+    CHECK(breaker.state(now) == CircuitState::Open);
+    CHECK_FALSE(breaker.can_send(now + 500ms));
+
+    // Half-open: a single probe is allowed through
+    now += 1s;
+    CHECK(breaker.state(now) == CircuitState::HalfOpen);
+    CHECK(breaker.can_send(now));
+    auto probe = breaker.on_send(now);
+    CHECK_FALSE(breaker.can_send(now));
+
+    // The probe fails so the breaker opens again
+    breaker.on_failure(probe, now);
+    CHECK(breaker.state(now) == CircuitState::Open);
+
+    now += 1s;
+    breaker.on_success(breaker.on_send(now));
+    CHECK(breaker.state(now) == CircuitState::Closed);
+    CHECK(breaker.can_send(now));
+}
+
+TEST_CASE("[ltb][net] circuit_breaker opens when the failure rate is too high") {
+    CircuitBreakerOptions options;
+    options.consecutive_failures = 0u;
+    options.failure_rate         = 0.5;
+    options.window_size          = 10u;
+    options.minimum_calls        = 10u;
+
+    auto           now = CircuitBreaker::Clock::time_point{};
+    CircuitBreaker breaker(options);
+
+    // Alternating failures never trigger a consecutive failure check
+    for (auto i = 0; i < 9; ++i) {
+        if (i % 2 == 0) {
+            breaker.on_failure(breaker.on_send(now), now);
+        } else {
+            breaker.on_success(breaker.on_send(now));
+        }
+        CHECK(breaker.state(now) == CircuitState::Closed);
+    }
+    breaker.on_failure(breaker.on_send(now), now);
+    CHECK(breaker.state(now) == CircuitState::Open);
+}
+
+TEST_CASE("[ltb][net] circuit_breaker ignores calls sent before the circuit opened") {
+    using namespace std::chrono_literals;
+
+    CircuitBreakerOptions options;
+    options.consecutive_failures = 2u;
+    options.open_duration        = 1s;
+    options.half_open_probes     = 2u;
+
+    auto           now = CircuitBreaker::Clock::time_point{};
+    CircuitBreaker breaker(options);
+
+    std::vector<CircuitBreaker::Generation> stragglers;
+    for (auto i = 0; i < 4; ++i) {
+        stragglers.emplace_back(breaker.on_send(now));
+    }
+    breaker.on_failure(stragglers[0], now);
+    breaker.on_failure(stragglers[1], now);
+    CHECK(breaker.state(now) == CircuitState::Open);
+
+    now += 1s;
+    auto probe = breaker.on_send(now);
+    CHECK(breaker.state(now) == CircuitState::HalfOpen);
+
+    // Calls sent while the circuit was closed neither close it, reopen it nor free a probe.
+    breaker.on_success(stragglers[2]);
+    breaker.on_failure(stragglers[3], now);
+    CHECK(breaker.state(now) == CircuitState::HalfOpen);
+    CHECK(breaker.can_send(now));
+    auto second_probe = breaker.on_send(now);
+    CHECK_FALSE(breaker.can_send(now));
+
+    breaker.on_success(probe);
+    CHECK(breaker.state(now) == CircuitState::HalfOpen);
+    breaker.on_success(second_probe);
+    CHECK(breaker.state(now) == CircuitState::Closed);
+
+    // A probe finishing after another one reopened the circuit doesn't count toward closing it.
+    breaker.on_failure(breaker.on_send(now), now);
+    breaker.on_failure(breaker.on_send(now), now);
+    now += 1s;
+    auto failed_probe = breaker.on_send(now);
+    auto late_probe   = breaker.on_send(now);
+    breaker.on_failure(failed_probe, now);
+    CHECK(breaker.state(now) == CircuitState::Open);
+
+    now += 1s;
+    auto next_probe = breaker.on_send(now);
+    breaker.on_success(late_probe);
+    breaker.on_success(next_probe);
+    CHECK(breaker.state(now) == CircuitState::HalfOpen);
+}
+
+} // namespace ltb::net
@@ -0,0 +1,99 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// project
+#include "ltb/util/duration.hpp"
+
+// standard
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ltb::net {
+
+enum class CircuitState {
+    Closed, ///< Calls are sent normally.
+    Open, ///< Calls fail locally without being sent.
+    HalfOpen, ///< Only a few probe calls are sent to check if the backend recovered.
+};
+
+struct CircuitBreakerOptions {
+    /// \brief Open after this many failures in a row. Zero disables the check.
+    std::size_t consecutive_failures = 5u;
+
+    /// \brief Open when at least this fraction of the last 'window_size' calls failed.
+    double      failure_rate  = 0.5;
+    std::size_t window_size   = 20u;
+    std::size_t minimum_calls = 10u; ///< Calls needed in the window before the failure rate is used.
+
+    /// \brief How long to stay open before sending probe calls.
+    util::Duration open_duration = std::chrono::seconds(5);
+
+    /// \brief Probe calls allowed at once while half-open. The circuit closes after this many succeed.
+    std::size_t half_open_probes = 1u;
+};
+
+/// \brief Tracks the health of a backend from the results of the calls sent to it.
+///
+/// Every change of state starts a new generation. Results are reported with the generation
+/// their call was sent in and are ignored once the state has moved on, so calls sent while
+/// the circuit was closed can't decide the fate of the probes sent while it is half-open.
+class CircuitBreaker {
+public:
+    using Clock      = std::chrono::steady_clock;
+    using Generation = std::uint64_t;
+
+    explicit CircuitBreaker(CircuitBreakerOptions options = {});
+
+    [[nodiscard]] auto can_send(Clock::time_point now) const -> bool;
+
+    /// \brief Record that a call was sent. Must only be called if 'can_send' returned true.
+    /// \return The generation to report the call's result with.
+    auto on_send(Clock::time_point now) -> Generation;
+    auto on_success(Generation sent_in) -> void;
+    auto on_failure(Generation sent_in, Clock::time_point now) -> void;
+
+    [[nodiscard]] auto state(Clock::time_point now) const -> CircuitState;
+
+private:
+    CircuitBreakerOptions options_;
+    CircuitState          state_      = CircuitState::Closed;
+    Generation            generation_ = 0u;
+    Clock::time_point     opened_at_;
+
+    std::vector<bool> window_;
+    std::size_t       window_index_         = 0u;
+    std::size_t       window_failures_      = 0u;
+    std::size_t       consecutive_failures_ = 0u;
+
+    std::size_t probes_in_flight_ = 0u;
+    std::size_t probe_successes_  = 0u;
+
+    auto record(bool failed) -> void;
+    auto open(Clock::time_point now) -> void;
+    auto close() -> void;
+};
+
+} // namespace ltb::net
@@ -0,0 +1,134 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "consistent_hash.hpp"
+
+// external
+#include <doctest/doctest.h>
+
+// standard
+#include <unordered_map>
+#include <vector>
+
+namespace ltb::net {
+namespace {
+
+// https://xorshift.di.unimi.it/splitmix64.c
+auto mix(std::uint64_t value) -> std::uint64_t {
+    value += 0x9e3779b97f4a7c15u;
+    value = (value ^ (value >> 30u)) * 0xbf58476d1ce4e5b9u;
+    value = (value ^ (value >> 27u)) * 0x94d049bb133111ebu;
+    return value ^ (value >> 31u);
+}
+
+} // namespace
+
+auto stable_hash(std::string const& str) -> std::uint64_t {
+    std::uint64_t hash = 0xcbf29ce484222325u;
+    for (auto c : str) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3u;
+    }
+    return hash;
+}
+
+auto rendezvous_score(std::uint64_t backend_hash, std::uint64_t key_hash) -> std::uint64_t {
+    return mix(backend_hash ^ mix(key_hash));
+}
+
+namespace {
+
+auto pick(std::vector<std::string> const& backends,
+          std::string const&              key,
+          std::vector<bool> const&        available = {}) -> std::string {
+    auto best = pick_rendezvous(
+        backends.size(),
+        stable_hash(key),
+        [&backends](std::size_t i) { return stable_hash(backends[i]); },
+        [&available](std::size_t i) { return available.empty() || available[i]; });
+    return (best < backends.size() ? backends[best] : "");
+}
+
+} // namespace
+
+TEST_CASE("[ltb][net] rendezvous hashing only moves keys belonging to the changed backend") {
+    std::vector<std::string> backends = {"a:1", "b:2", "c:3", "d:4"};
+
+    constexpr auto key_count = 10'000;
+
+    std::unordered_map<std::string, std::string> before;
+    std::unordered_map<std::string, int>         counts;
+    for (auto i = 0; i < key_count; ++i) {
+        auto key    = "key" + std::to_string(i);
+        before[key] = pick(backends, key);
+        ++counts[before[key]];
+    }
+
+    // Roughly even spread
+    for (auto const& backend : backends) {
+        CHECK(counts[backend] > key_count / 8);
+    }
+
+    backends.emplace_back("e:5");
+
+    auto moved = 0;
+    for (auto const& [key, old_backend] : before) {
+        auto new_backend = pick(backends, key);
+        if (new_backend != old_backend) {
+            CHECK(new_backend == "e:5");
+            ++moved;
+        }
+    }
+
+    // ~1/5 of the keys should move to the new backend
+    CHECK(moved > key_count / 10);
+    CHECK(moved < key_count * 3 / 10);
+}
+
+TEST_CASE("[ltb][net] rendezvous hashing spills keys of unavailable backends over to the next best") {
+    std::vector<std::string> backends  = {"a:1", "b:2", "c:3", "d:4"};
+    std::vector<bool>        available = {true, false, true, true};
+
+    constexpr auto key_count = 1'000;
+
+    auto moved = 0;
+    for (auto i = 0; i < key_count; ++i) {
+        auto key         = "key" + std::to_string(i);
+        auto old_backend = pick(backends, key);
+        auto new_backend = pick(backends, key, available);
+
+        CHECK(new_backend != "b:2");
+        if (old_backend != "b:2") {
+            CHECK(new_backend == old_backend);
+        } else {
+            // The runner-up, which is where the key goes if "b:2" is removed.
+            CHECK(new_backend == pick({"a:1", "c:3", "d:4"}, key));
+            ++moved;
+        }
+    }
+    CHECK(moved > 0);
+
+    CHECK(pick(backends, "key", {false, false, false, false}).empty());
+    CHECK(pick({}, "key").empty());
+}
+
+} // namespace ltb::net
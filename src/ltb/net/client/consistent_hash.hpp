@@ -0,0 +1,66 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// standard
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ltb::net {
+
+/// \brief A stable 64 bit hash (FNV-1a) so keys map to the same backend in every process.
+auto stable_hash(std::string const& str) -> std::uint64_t;
+
+/// \brief The rendezvous (highest random weight) score of a key for a backend.
+///
+/// Each key is sent to the backend with the highest score. Adding or removing a
+/// backend only moves the keys that scored highest on that backend (~1/N of them).
+auto rendezvous_score(std::uint64_t backend_hash, std::uint64_t key_hash) -> std::uint64_t;
+
+/// \brief The index of the backend with the highest rendezvous score for 'key_hash'.
+///
+/// 'backend_hash(i)' is the stable_hash of backend i's address. Backends rejected by
+/// 'is_available(i)' are skipped so their keys spill over to the next best backend.
+/// Returns 'backend_count' if none is available.
+template <typename BackendHash, typename IsAvailable>
+auto pick_rendezvous(std::size_t        backend_count,
+                     std::uint64_t      key_hash,
+                     BackendHash const& backend_hash,
+                     IsAvailable const& is_available) -> std::size_t {
+    auto          best       = backend_count;
+    std::uint64_t best_score = 0u;
+    for (auto i = std::size_t{0u}; i < backend_count; ++i) {
+        if (!is_available(i)) {
+            continue;
+        }
+        auto score = rendezvous_score(backend_hash(i), key_hash);
+        if (best == backend_count || score > best_score) {
+            best       = i;
+            best_score = score;
+        }
+    }
+    return best;
+}
+
+} // namespace ltb::net
@@ -0,0 +1,214 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "timer_wheel.hpp"
+
+// external
+#include <doctest/doctest.h>
+
+// standard
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace ltb::net {
+
+TimerWheel::TimerWheel(Clock::duration resolution, Clock::time_point start) : resolution_(resolution), start_(start) {
+    if (resolution_ <= Clock::duration::zero()) {
+        throw std::invalid_argument("TimerWheel resolution must be positive");
+    }
+}
+
+auto TimerWheel::schedule(Clock::time_point deadline, void* data, Clock::time_point now) -> TimerId {
+    if (timers_.empty()) {
+        // Otherwise the next advance() would step through every tick since the wheel went idle.
+        current_tick_ = std::max(current_tick_, to_tick(now, false));
+    }
+
+    auto id          = next_id_++;
+    auto expiry_tick = std::max(to_tick(deadline, true), current_tick_ + 1u);
+
+    auto [level, slot] = location(expiry_tick);
+    auto& timers       = wheels_[level][slot];
+    timers.push_front(Timer{id, expiry_tick, data, level, slot});
+    timers_.emplace(id, timers.begin());
+    return id;
+}
+
+auto TimerWheel::cancel(TimerId id) -> bool {
+    auto iter = timers_.find(id);
+    if (iter == timers_.end()) {
+        return false;
+    }
+    auto timer = iter->second;
+    wheels_[timer->level][timer->slot].erase(timer);
+    timers_.erase(iter);
+    return true;
+}
+
+auto TimerWheel::advance(Clock::time_point now, ExpiredCallback const& on_expired) -> void {
+    auto target_tick = to_tick(now, false);
+
+    while (current_tick_ < target_tick) {
+        if (timers_.empty()) {
+            current_tick_ = target_tick;
+            break;
+        }
+        ++current_tick_;
+
+        // Move timers down from the higher levels each time a lower level wraps around.
+        for (auto level = 1u; level < levels; ++level) {
+            if ((current_tick_ & ((std::uint64_t{1} << (level * level_bits)) - 1u)) != 0u) {
+                break;
+            }
+            Slot cascading;
+            cascading.splice(cascading.end(), wheels_[level][(current_tick_ >> (level * level_bits)) & level_mask]);
+            while (!cascading.empty()) {
+                relocate(cascading, cascading.begin());
+            }
+        }
+
+        Slot expired;
+        expired.splice(expired.end(), wheels_[0][current_tick_ & level_mask]);
+        for (auto const& timer : expired) {
+            timers_.erase(timer.id);
+        }
+        for (auto const& timer : expired) {
+            on_expired(timer.data);
+        }
+    }
+}
+
+auto TimerWheel::empty() const -> bool {
+    return timers_.empty();
+}
+
+auto TimerWheel::size() const -> std::size_t {
+    return timers_.size();
+}
+
+auto TimerWheel::resolution() const -> Clock::duration {
+    return resolution_;
+}
+
+auto TimerWheel::to_tick(Clock::time_point time_point, bool round_up) const -> std::uint64_t {
+    if (time_point <= start_) {
+        return 0u;
+    }
+    auto elapsed = time_point - start_;
+    auto ticks   = static_cast<std::uint64_t>(elapsed / resolution_);
+    if (round_up && elapsed % resolution_ != Clock::duration::zero()) {
+        ++ticks;
+    }
+    return ticks;
+}
+
+auto TimerWheel::location(std::uint64_t expiry_tick) const -> std::pair<std::size_t, std::size_t> {
+    constexpr auto max_delta = (std::uint64_t{1} << (levels * level_bits)) - 1u;
+
+    // Timers beyond the last level wait in it and get re-placed when it cascades.
+    auto delta = std::min(expiry_tick - current_tick_, max_delta);
+    auto tick  = current_tick_ + delta;
+
+    auto level = std::size_t{0};
+    while (level + 1u < levels && delta >= (std::uint64_t{1} << ((level + 1u) * level_bits))) {
+        ++level;
+    }
+    return {level, (tick >> (level * level_bits)) & level_mask};
+}
+
+auto TimerWheel::relocate(Slot& from, Slot::iterator timer) -> void {
+    auto [level, slot] = location(std::max(timer->expiry_tick, current_tick_));
+    timer->level       = level;
+    timer->slot        = slot;
+
+    // Splicing keeps the iterator stored in 'timers_' valid.
+    auto& to = wheels_[level][slot];
+    to.splice(to.begin(), from, timer);
+}
+
+TEST_CASE("[ltb][net] timer_wheel expires timers on time across all levels") {
+    using namespace std::chrono_literals;
+
+    auto       start = TimerWheel::Clock::time_point{};
+    TimerWheel wheel(1ms, start);
+
+    std::mt19937                                gen(42u);
+    std::uniform_int_distribution<std::int64_t> dist(1, 2'000'000); // up to ~33 minutes
+
+    constexpr auto timer_count = 2'000;
+
+    std::vector<TimerWheel::Clock::time_point> deadlines(timer_count);
+    std::vector<TimerWheel::TimerId>           ids(timer_count);
+    for (auto i = 0u; i < deadlines.size(); ++i) {
+        deadlines[i] = start + std::chrono::milliseconds(dist(gen));
+        ids[i]       = wheel.schedule(deadlines[i], &deadlines[i], start);
+    }
+    CHECK(wheel.size() == timer_count);
+
+    // Cancel every tenth timer
+    for (auto i = 0u; i < ids.size(); i += 10u) {
+        CHECK(wheel.cancel(ids[i]));
+        CHECK_FALSE(wheel.cancel(ids[i]));
+    }
+
+    auto now          = start;
+    auto expire_count = 0u;
+    auto late_count   = 0u;
+    auto early_count  = 0u;
+    while (!wheel.empty()) {
+        auto previous = now;
+        now += std::chrono::milliseconds(dist(gen) % 5'000);
+        wheel.advance(now, [&](void* data) {
+            auto deadline = *static_cast<TimerWheel::Clock::time_point*>(data);
+            early_count += (deadline > now ? 1u : 0u);
+            late_count += (deadline <= previous ? 1u : 0u);
+            ++expire_count;
+        });
+    }
+    CHECK(expire_count == timer_count - timer_count / 10);
+    CHECK(early_count == 0u);
+    CHECK(late_count == 0u);
+}
+
+TEST_CASE("[ltb][net] timer_wheel schedules timers on time after a long idle gap") {
+    using namespace std::chrono_literals;
+
+    auto       start = TimerWheel::Clock::time_point{};
+    TimerWheel wheel(1ms, start);
+
+    auto expired    = 0;
+    auto on_expired = [&expired](void*) { ++expired; };
+
+    // Nothing advances an empty wheel, e.g. the wheel of a client that made no calls for a year.
+    auto now = start + 24h * 365;
+    wheel.schedule(now + 5ms, nullptr, now);
+
+    wheel.advance(now + 4ms, on_expired);
+    CHECK(expired == 0);
+    wheel.advance(now + 5ms, on_expired);
+    CHECK(expired == 1);
+    CHECK(wheel.empty());
+}
+
+} // namespace ltb::net
@@ -0,0 +1,87 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// standard
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+namespace ltb::net {
+
+/// \brief A hierarchical timer wheel with O(1) scheduling and cancellation.
+///
+/// Time is split into ticks of 'resolution'. Four levels of 64 slots cover
+/// 2^24 ticks, and timers further out than that wait in the last level.
+class TimerWheel {
+public:
+    using Clock           = std::chrono::steady_clock;
+    using TimerId         = std::uint64_t;
+    using ExpiredCallback = std::function<void(void*)>;
+
+    explicit TimerWheel(Clock::duration resolution = std::chrono::milliseconds(10),
+                        Clock::time_point start      = Clock::now());
+
+    /// \brief 'now' catches an empty wheel up, since nothing advances it while it has no timers.
+    auto schedule(Clock::time_point deadline, void* data, Clock::time_point now) -> TimerId;
+    auto cancel(TimerId id) -> bool;
+
+    /// \brief Calls 'on_expired' with the data of every timer due at or before 'now'.
+    auto advance(Clock::time_point now, ExpiredCallback const& on_expired) -> void;
+
+    [[nodiscard]] auto empty() const -> bool;
+    [[nodiscard]] auto size() const -> std::size_t;
+    [[nodiscard]] auto resolution() const -> Clock::duration;
+
+private:
+    static constexpr std::uint64_t level_bits = 6u;
+    static constexpr std::uint64_t slot_count = 1u << level_bits;
+    static constexpr std::uint64_t level_mask = slot_count - 1u;
+    static constexpr std::size_t   levels     = 4u;
+
+    struct Timer {
+        TimerId       id;
+        std::uint64_t expiry_tick;
+        void*         data;
+        std::size_t   level;
+        std::size_t   slot;
+    };
+    using Slot = std::list<Timer>;
+
+    Clock::duration                                  resolution_;
+    Clock::time_point                                start_;
+    std::uint64_t                                    current_tick_ = 0u;
+    TimerId                                          next_id_      = 1u;
+    std::array<std::array<Slot, slot_count>, levels> wheels_;
+    std::unordered_map<TimerId, Slot::iterator>      timers_;
+
+    [[nodiscard]] auto to_tick(Clock::time_point time_point, bool round_up) const -> std::uint64_t;
+    [[nodiscard]] auto location(std::uint64_t expiry_tick) const -> std::pair<std::size_t, std::size_t>;
+
+    auto relocate(Slot& from, Slot::iterator timer) -> void;
+};
+
+} // namespace ltb::net
@@ -0,0 +1,164 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// project
+#include "ltb/net/client/async_client_data.hpp"
+#include "ltb/util/result.hpp"
+
+// standard
+#include <functional>
+#include <optional>
+
+namespace ltb::net {
+namespace detail {
+
+// The awaitable whose call is being submitted on this thread. Completions that happen
+// during submission come from calls that failed before they were sent.
+inline thread_local void const* submitting_awaitable = nullptr;
+
+} // namespace detail
+
+/// \brief Runs a coroutine continuation, e.g. by posting it to a thread pool.
+using ResumeExecutor = std::function<void(std::function<void()>)>;
+
+/// \brief 'co_await'-ing this makes a unary call and yields its response or error.
+///
+/// The coroutine is resumed on the client's completion queue thread unless
+/// 'resume_on' is given an executor. It is resumed immediately if the call
+/// fails before it is sent. The coroutine handle is type-erased so this type
+/// compiles as C++17 (see ltb/net/coro/client_task.hpp for the C++20 side).
+template <typename Client, typename CallPtr, typename Request, typename Response>
+class UnaryCallAwaitable {
+public:
+    explicit UnaryCallAwaitable(Client& client, CallPtr call_ptr, Request request, CallOptions options);
+
+    /// \brief Only valid before the awaitable is awaited, e.g. to collect calls for 'when_all'.
+    UnaryCallAwaitable(UnaryCallAwaitable&& other) noexcept;
+    UnaryCallAwaitable(UnaryCallAwaitable const&) = delete;
+
+    auto operator=(UnaryCallAwaitable&&) -> UnaryCallAwaitable& = delete;
+    auto operator=(UnaryCallAwaitable const&) -> UnaryCallAwaitable& = delete;
+
+    auto resume_on(ResumeExecutor executor) && -> UnaryCallAwaitable&&;
+
+    auto await_ready() const -> bool { return false; }
+
+    template <typename CoroutineHandle>
+    auto await_suspend(CoroutineHandle handle) -> bool;
+
+    auto await_resume() -> util::Result<Response>;
+
+private:
+    Client&        client_;
+    CallPtr        call_ptr_;
+    Request        request_;
+    CallOptions    options_;
+    ResumeExecutor executor_;
+
+    std::optional<Response>    response_;
+    std::optional<util::Error> error_;
+
+    void* coroutine_                 = nullptr;
+    void (*resume_coroutine_)(void*) = nullptr;
+
+    auto on_complete() -> void;
+};
+
+template <typename Client, typename CallPtr, typename Request, typename Response>
+UnaryCallAwaitable<Client, CallPtr, Request, Response>::UnaryCallAwaitable(Client&     client,
+                                                                          CallPtr     call_ptr,
+                                                                          Request     request,
+                                                                          CallOptions options)
+    : client_(client), call_ptr_(call_ptr), request_(std::move(request)), options_(std::move(options)) {}
+
+template <typename Client, typename CallPtr, typename Request, typename Response>
+UnaryCallAwaitable<Client, CallPtr, Request, Response>::UnaryCallAwaitable(UnaryCallAwaitable&& other) noexcept
+    : client_(other.client_),
+      call_ptr_(other.call_ptr_),
+      request_(std::move(other.request_)),
+      options_(std::move(other.options_)),
+      executor_(std::move(other.executor_)) {}
+
+template <typename Client, typename CallPtr, typename Request, typename Response>
+auto UnaryCallAwaitable<Client, CallPtr, Request, Response>::resume_on(ResumeExecutor executor) &&
+    -> UnaryCallAwaitable&& {
+    executor_ = std::move(executor);
+    return std::move(*this);
+}
+
+template <typename Client, typename CallPtr, typename Request, typename Response>
+template <typename CoroutineHandle>
+auto UnaryCallAwaitable<Client, CallPtr, Request, Response>::await_suspend(CoroutineHandle handle) -> bool {
+    coroutine_        = handle.address();
+    resume_coroutine_ = [](void* address) { CoroutineHandle::from_address(address).resume(); };
+
+    detail::submitting_awaitable = this;
+    auto result                  = client_.template unary_rpc<Response>(
+        call_ptr_,
+        request_,
+        [this](Response const& response) { response_ = response; },
+        [this](grpc::Status const& status) {
+            if (!status.ok()) {
+                error_ = LTB_MAKE_ERROR(status.error_message());
+            }
+            on_complete();
+        },
+        [this](util::Error const& error) {
+            error_ = error;
+            on_complete();
+        },
+        options_);
+    detail::submitting_awaitable = nullptr;
+
+    if (result == SubmitResult::TryLater) {
+        error_ = LTB_MAKE_ERROR("Too many outstanding calls.");
+    }
+
+    // A submitted call resumes the coroutine when it completes, possibly before this returns,
+    // so 'this' must not be touched after suspending.
+    return result == SubmitResult::Submitted;
+}
+
+template <typename Client, typename CallPtr, typename Request, typename Response>
+auto UnaryCallAwaitable<Client, CallPtr, Request, Response>::await_resume() -> util::Result<Response> {
+    if (error_) {
+        return tl::make_unexpected(std::move(*error_));
+    }
+    return std::move(*response_);
+}
+
+template <typename Client, typename CallPtr, typename Request, typename Response>
+auto UnaryCallAwaitable<Client, CallPtr, Request, Response>::on_complete() -> void {
+    if (detail::submitting_awaitable == this) {
+        return; // The call failed before it was sent so 'await_suspend' won't suspend.
+    }
+
+    if (executor_) {
+        executor_([coroutine = coroutine_, resume_coroutine = resume_coroutine_] { resume_coroutine(coroutine); });
+    } else {
+        resume_coroutine_(coroutine_);
+    }
+}
+
+} // namespace ltb::net
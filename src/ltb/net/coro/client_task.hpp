@@ -0,0 +1,227 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+#error "ltb/net/coro requires C++20 coroutines (configure with LTB_NET_ENABLE_COROUTINES=ON)"
+#endif
+
+// project
+#include "frame_pool.hpp"
+
+// standard
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ltb::net {
+namespace detail {
+
+/// \brief Holds what a Task yields (nothing for Task<void>).
+template <typename T>
+struct TaskResult {
+    auto return_value(T value) -> void { result.emplace(std::move(value)); }
+    auto take() -> T { return std::move(*result); }
+
+    std::optional<T> result;
+};
+
+template <>
+struct TaskResult<void> {
+    auto return_void() -> void {}
+    auto take() -> void {}
+};
+
+} // namespace detail
+
+/// \brief A lazily started coroutine that yields a 'T' to the coroutine awaiting it, or
+///        nothing for a Task<void>.
+///
+/// Used to compose client calls, e.g.
+///
+/// \code
+///  auto login(AsyncClient<Users>& client, Credentials credentials) -> Task<util::Result<Session>> {
+///      auto user = co_await client.call(&Users::Stub::AsyncFindUser, credentials);
+///      if (!user) {
+///          co_return tl::make_unexpected(user.error());
+///      }
+///      co_return co_await client.call(&Users::Stub::AsyncStartSession, *user);
+///  }
+/// \endcode
+///
+/// Frames come from a pool. Exceptions escaping the coroutine terminate the program.
+template <typename T>
+class [[nodiscard]] Task {
+public:
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    struct FinalAwaitable {
+        auto await_ready() const noexcept -> bool { return false; }
+        auto await_suspend(Handle handle) noexcept -> std::coroutine_handle<> {
+            return handle.promise().continuation;
+        }
+        auto await_resume() const noexcept -> void {}
+    };
+
+    struct promise_type : public detail::TaskResult<T> {
+        static auto operator new(std::size_t size) -> void* { return detail::FramePool::allocate(size); }
+        static auto operator delete(void* frame, std::size_t size) -> void {
+            detail::FramePool::deallocate(frame, size);
+        }
+
+        auto get_return_object() -> Task { return Task{Handle::from_promise(*this)}; }
+        auto initial_suspend() noexcept -> std::suspend_always { return {}; }
+        auto final_suspend() noexcept -> FinalAwaitable { return {}; }
+        auto unhandled_exception() -> void { std::terminate(); }
+
+        std::coroutine_handle<> continuation = std::noop_coroutine();
+    };
+
+    explicit Task(Handle handle) : handle_(handle) {}
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task(Task const&) = delete;
+    ~Task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    auto operator=(Task&&) -> Task& = delete;
+    auto operator=(Task const&) -> Task& = delete;
+
+    auto await_ready() const -> bool { return false; }
+    auto await_suspend(std::coroutine_handle<> continuation) -> std::coroutine_handle<> {
+        handle_.promise().continuation = continuation;
+        return handle_;
+    }
+    auto await_resume() -> T { return handle_.promise().take(); }
+
+private:
+    Handle handle_;
+};
+
+namespace detail {
+
+/// \brief Runs an awaitable to completion without anything awaiting it.
+struct DetachedTask {
+    struct promise_type {
+        static auto operator new(std::size_t size) -> void* { return FramePool::allocate(size); }
+        static auto operator delete(void* frame, std::size_t size) -> void { FramePool::deallocate(frame, size); }
+
+        auto get_return_object() -> DetachedTask { return {}; }
+        auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+        auto final_suspend() noexcept -> std::suspend_never { return {}; }
+        auto return_void() -> void {}
+        auto unhandled_exception() -> void { std::terminate(); }
+    };
+};
+
+template <typename Awaitable>
+using AwaitResult = decltype(std::declval<Awaitable>().await_resume());
+
+template <typename Awaitable>
+class WhenAllAwaitable {
+public:
+    using Result = AwaitResult<Awaitable>;
+
+    explicit WhenAllAwaitable(std::vector<Awaitable> awaitables)
+        : awaitables_(std::move(awaitables)), results_(awaitables_.size()) {}
+
+    auto await_ready() const -> bool { return awaitables_.empty(); }
+
+    auto await_suspend(std::coroutine_handle<> continuation) -> bool {
+        continuation_ = continuation;
+
+        // The extra count keeps the last awaitable from resuming us before every one has started.
+        remaining_.store(awaitables_.size() + 1u);
+        for (auto i = 0u; i < awaitables_.size(); ++i) {
+            run(i);
+        }
+        return remaining_.fetch_sub(1u) != 1u;
+    }
+
+    auto await_resume() -> std::vector<Result> {
+        auto results = std::vector<Result>{};
+        results.reserve(results_.size());
+        for (auto& result : results_) {
+            results.emplace_back(std::move(*result));
+        }
+        return results;
+    }
+
+private:
+    std::vector<Awaitable>             awaitables_;
+    std::vector<std::optional<Result>> results_;
+    std::atomic<std::size_t>           remaining_ = 0u;
+    std::coroutine_handle<>            continuation_;
+
+    auto run(std::size_t index) -> DetachedTask {
+        results_[index].emplace(co_await std::move(awaitables_[index]));
+        if (remaining_.fetch_sub(1u) == 1u) {
+            continuation_.resume();
+        }
+    }
+};
+
+} // namespace detail
+
+/// \brief Awaits every awaitable concurrently and yields their results in the same order.
+///
+/// \code
+///  auto calls = std::vector<decltype(client.call(&Stub::AsyncGetUser, User::Id{}))>{};
+///  for (auto const& id : ids) {
+///      calls.emplace_back(client.call(&Stub::AsyncGetUser, id));
+///  }
+///  auto users = co_await when_all(std::move(calls));
+/// \endcode
+template <typename Awaitable>
+auto when_all(std::vector<Awaitable> awaitables) -> detail::WhenAllAwaitable<Awaitable> {
+    return detail::WhenAllAwaitable<Awaitable>(std::move(awaitables));
+}
+
+/// \brief Blocks the calling thread until 'task' completes. It must not be called from
+///        a thread the task needs to make progress (e.g. a client's completion queue thread).
+template <typename T>
+auto sync_wait(Task<T> task) -> T {
+    auto promise = std::promise<T>{};
+    auto future  = promise.get_future();
+
+    [](Task<T> inner, std::promise<T>& result) -> detail::DetachedTask {
+        if constexpr (std::is_void_v<T>) {
+            co_await std::move(inner);
+            result.set_value();
+        } else {
+            result.set_value(co_await std::move(inner));
+        }
+    }(std::move(task), promise);
+
+    return future.get();
+}
+
+} // namespace ltb::net
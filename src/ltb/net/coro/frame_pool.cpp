@@ -0,0 +1,105 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "frame_pool.hpp"
+
+// external
+#include <doctest/doctest.h>
+
+// standard
+#include <array>
+#include <new>
+#include <vector>
+
+namespace ltb::net::detail {
+namespace {
+
+constexpr auto size_class_count = FramePool::max_pooled_size / FramePool::size_class_bytes;
+
+auto size_class(std::size_t size) -> std::size_t {
+    return (size + FramePool::size_class_bytes - 1u) / FramePool::size_class_bytes - 1u;
+}
+
+struct FreeLists {
+    std::array<std::vector<void*>, size_class_count> frames;
+
+    ~FreeLists() {
+        for (auto& free_frames : frames) {
+            for (auto* frame : free_frames) {
+                ::operator delete(frame);
+            }
+        }
+    }
+};
+
+auto free_lists() -> FreeLists& {
+    thread_local FreeLists lists;
+    return lists;
+}
+
+} // namespace
+
+auto FramePool::allocate(std::size_t size) -> void* {
+    if (size == 0u || size > max_pooled_size) {
+        return ::operator new(size);
+    }
+    auto& free_frames = free_lists().frames[size_class(size)];
+    if (free_frames.empty()) {
+        // Round up so any frame in this size class can reuse the memory.
+        return ::operator new((size_class(size) + 1u) * size_class_bytes);
+    }
+    auto* frame = free_frames.back();
+    free_frames.pop_back();
+    return frame;
+}
+
+auto FramePool::deallocate(void* frame, std::size_t size) -> void {
+    if (size == 0u || size > max_pooled_size) {
+        ::operator delete(frame);
+        return;
+    }
+    auto& free_frames = free_lists().frames[size_class(size)];
+    if (free_frames.size() >= max_free_frames) {
+        ::operator delete(frame);
+        return;
+    }
+    free_frames.push_back(frame);
+}
+
+TEST_CASE("[ltb][net] frame_pool reuses frames of the same size class") {
+    auto* first = FramePool::allocate(100u);
+    FramePool::deallocate(first, 100u);
+
+    auto* second = FramePool::allocate(120u);
+    CHECK(second == first);
+
+    auto* third = FramePool::allocate(100u);
+    CHECK(third != second);
+
+    FramePool::deallocate(second, 120u);
+    FramePool::deallocate(third, 100u);
+
+    auto* large = FramePool::allocate(FramePool::max_pooled_size + 1u);
+    FramePool::deallocate(large, FramePool::max_pooled_size + 1u);
+}
+
+} // namespace ltb::net::detail
@@ -0,0 +1,44 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// standard
+#include <cstddef>
+
+namespace ltb::net::detail {
+
+/// \brief Recycles coroutine frames so starting a handler does not hit the global allocator.
+///
+/// Frames are grouped into 64 byte size classes held in thread local free lists,
+/// which suits frames that are created and destroyed on a completion queue thread.
+/// Frames larger than 'max_pooled_size' use the global allocator.
+struct FramePool {
+    static constexpr std::size_t size_class_bytes = 64u;
+    static constexpr std::size_t max_pooled_size  = 2048u;
+    static constexpr std::size_t max_free_frames  = 256u; ///< Per size class and thread
+
+    static auto allocate(std::size_t size) -> void*;
+    static auto deallocate(void* frame, std::size_t size) -> void;
+};
+
+} // namespace ltb::net::detail
@@ -0,0 +1,73 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+#error "ltb/net/coro requires C++20 coroutines (configure with LTB_NET_ENABLE_COROUTINES=ON)"
+#endif
+
+// project
+#include "frame_pool.hpp"
+
+// standard
+#include <coroutine>
+#include <exception>
+
+namespace ltb::net {
+
+/// \brief The return type of coroutine handlers registered with an AsyncServer.
+///
+/// The coroutine starts running as soon as the handler is invoked and destroys
+/// itself when it returns. Any handler signature accepted by 'register_rpc' can be
+/// a coroutine, e.g.
+///
+/// \code
+///  server.register_rpc(&Service::AsyncService::RequestChat,
+///                      [](AsyncServerReaderWriter<ChatMessage, ChatMessage> stream) -> ServerTask {
+///                          while (auto message = co_await stream.read()) {
+///                              if (!co_await stream.write(*message)) {
+///                                  co_return;
+///                              }
+///                          }
+///                          stream.finish(grpc::Status::OK);
+///                      });
+/// \endcode
+///
+/// Awaited stream operations resume on the server's completion queue thread.
+/// Exceptions escaping a handler terminate the program.
+struct ServerTask {
+    struct promise_type {
+        static auto operator new(std::size_t size) -> void* { return detail::FramePool::allocate(size); }
+        static auto operator delete(void* frame, std::size_t size) -> void {
+            detail::FramePool::deallocate(frame, size);
+        }
+
+        auto get_return_object() -> ServerTask { return {}; }
+        auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+        auto final_suspend() noexcept -> std::suspend_never { return {}; }
+        auto return_void() -> void {}
+        auto unhandled_exception() -> void { std::terminate(); }
+    };
+};
+
+} // namespace ltb::net
@@ -0,0 +1,155 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "event_loop.hpp"
+
+// project
+#include "tagger.hpp"
+
+// external
+#include <doctest/doctest.h>
+#include <grpc++/alarm.h>
+
+// standard
+#include <algorithm>
+#include <future>
+
+namespace ltb::net {
+
+EventLoop::EventLoop(std::size_t thread_count) {
+    if (thread_count == 0u) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    client_queues_.resize(thread_count);
+    for (auto& polled : client_queues_) {
+        polled.queue  = std::make_unique<grpc::CompletionQueue>();
+        polled.thread = std::thread(&EventLoop::poll, std::ref(*polled.queue));
+    }
+}
+
+EventLoop::~EventLoop() {
+    shutdown();
+}
+
+auto EventLoop::client_queue() -> grpc::CompletionQueue& {
+    std::lock_guard lock(mutex_);
+    auto& polled       = client_queues_[next_client_queue_];
+    next_client_queue_ = (next_client_queue_ + 1u) % client_queues_.size();
+    return *polled.queue;
+}
+
+auto EventLoop::attach_server_queue(std::unique_ptr<grpc::ServerCompletionQueue> queue)
+    -> grpc::ServerCompletionQueue& {
+    std::lock_guard lock(mutex_);
+    auto& server_queue = *queue;
+
+    PolledQueue polled;
+    polled.queue  = std::move(queue);
+    polled.thread = std::thread(&EventLoop::poll, std::ref(*polled.queue));
+    server_queues_.emplace_back(std::move(polled));
+
+    return server_queue;
+}
+
+auto EventLoop::detach_server_queue(grpc::ServerCompletionQueue& queue) -> void {
+    PolledQueue polled;
+    {
+        std::lock_guard lock(mutex_);
+        auto iter = std::find_if(server_queues_.begin(), server_queues_.end(), [&queue](auto const& p) {
+            return p.queue.get() == &queue;
+        });
+        if (iter == server_queues_.end()) {
+            return;
+        }
+        polled = std::move(*iter);
+        server_queues_.erase(iter);
+    }
+    polled.thread.join();
+}
+
+auto EventLoop::shutdown() -> void {
+    std::vector<PolledQueue> queues;
+    {
+        std::lock_guard lock(mutex_);
+        if (is_shutdown_) {
+            return;
+        }
+        is_shutdown_ = true;
+
+        for (auto& polled : client_queues_) {
+            polled.queue->Shutdown();
+        }
+        // Server queues are shut down by their servers.
+        queues = std::move(client_queues_);
+        std::move(server_queues_.begin(), server_queues_.end(), std::back_inserter(queues));
+        server_queues_.clear();
+    }
+
+    for (auto& polled : queues) {
+        polled.thread.join();
+    }
+}
+
+auto EventLoop::thread_count() -> std::size_t {
+    std::lock_guard lock(mutex_);
+    return client_queues_.size() + server_queues_.size();
+}
+
+auto EventLoop::poll(grpc::CompletionQueue& queue) -> void {
+    void* raw_tag                = {};
+    bool  completed_successfully = {};
+
+    while (queue.Next(&raw_tag, &completed_successfully)) {
+        detail::complete(raw_tag, completed_successfully);
+    }
+}
+
+TEST_CASE("[ltb][net] event_loop dispatches tags to their owner on the loop's threads") {
+    EventLoop loop(2u);
+    CHECK(loop.thread_count() == 2u);
+
+    std::promise<std::thread::id> handled_on;
+    std::promise<bool>            handled_ok;
+
+    ClientTagger tagger;
+    int          data = 0;
+    tagger.set_handler([&](ClientTag const& tag, bool completed_successfully) {
+        CHECK(tag.data == &data);
+        CHECK(tag.label == ClientTagLabel::TimerTick);
+        handled_on.set_value(std::this_thread::get_id());
+        handled_ok.set_value(completed_successfully);
+    });
+
+    grpc::Alarm alarm;
+    alarm.Set(&loop.client_queue(),
+              std::chrono::system_clock::now(),
+              tagger.make_tag(&data, ClientTagLabel::TimerTick));
+
+    CHECK(handled_on.get_future().get() != std::this_thread::get_id());
+    CHECK(handled_ok.get_future().get());
+
+    tagger.wait_for_outstanding_tags();
+    loop.shutdown();
+}
+
+} // namespace ltb::net
@@ -0,0 +1,85 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// external
+#include <grpc++/completion_queue.h>
+
+// standard
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ltb::net {
+
+/// \brief A pool of threads polling the completion queues of many clients and servers.
+///
+/// Without an event loop every AsyncClient and AsyncServer polls its own queue on the
+/// thread that calls run(). Clients constructed with an event loop share its queues, one
+/// per thread, and servers hand their queue to it so a single set of threads polls
+/// everything in the process. Tags are dispatched directly to their owner (see
+/// detail::CompletionTag) so the queues can be shared.
+///
+/// Attached clients and servers have to be shut down before the event loop.
+class EventLoop {
+public:
+    /// \brief 'thread_count' defaults to the number of hardware threads.
+    explicit EventLoop(std::size_t thread_count = 0u);
+    ~EventLoop();
+
+    EventLoop(EventLoop const&) = delete;
+    EventLoop(EventLoop&&)      = delete;
+    auto operator=(EventLoop const&) -> EventLoop& = delete;
+    auto operator=(EventLoop&&) -> EventLoop& = delete;
+
+    /// \brief The queue a new client should use. Clients are spread over the threads in turn.
+    auto client_queue() -> grpc::CompletionQueue&;
+
+    /// \brief Polls a server's queue on its own thread of the loop until the queue is shut down.
+    auto attach_server_queue(std::unique_ptr<grpc::ServerCompletionQueue> queue) -> grpc::ServerCompletionQueue&;
+
+    /// \brief Waits for a shut down server queue to drain and releases it.
+    auto detach_server_queue(grpc::ServerCompletionQueue& queue) -> void;
+
+    /// \brief Shuts down the client queues and waits for every thread to finish.
+    auto shutdown() -> void;
+
+    auto thread_count() -> std::size_t;
+
+private:
+    struct PolledQueue {
+        std::unique_ptr<grpc::CompletionQueue> queue;
+        std::thread                            thread;
+    };
+
+    std::mutex               mutex_;
+    std::vector<PolledQueue> client_queues_;
+    std::vector<PolledQueue> server_queues_;
+    std::size_t              next_client_queue_ = 0u;
+    bool                     is_shutdown_       = false;
+
+    static auto poll(grpc::CompletionQueue& queue) -> void;
+};
+
+} // namespace ltb::net
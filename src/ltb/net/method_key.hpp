@@ -0,0 +1,43 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// standard
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace ltb::net::detail {
+
+/// \brief Identifies an rpc by the bytes of its member function pointer so per-method
+///        settings can be looked up when a call is made.
+template <typename MemberFunctionPtr>
+auto method_key(MemberFunctionPtr member_function_ptr) -> std::string {
+    static_assert(std::is_member_function_pointer_v<MemberFunctionPtr>, "Expected a member function pointer");
+
+    std::string key(sizeof(member_function_ptr), '\0');
+    std::memcpy(key.data(), &member_function_ptr, sizeof(member_function_ptr));
+    return key;
+}
+
+} // namespace ltb::net::detail
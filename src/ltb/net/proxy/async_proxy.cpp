@@ -0,0 +1,170 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "async_proxy.hpp"
+
+// external
+#include <grpc++/create_channel.h>
+#include <grpc++/server_builder.h>
+
+namespace ltb::net {
+
+AsyncProxy::AsyncProxy(std::string const& host_address) : AsyncProxy(nullptr, host_address) {}
+
+AsyncProxy::AsyncProxy(EventLoop& event_loop, std::string const& host_address)
+    : AsyncProxy(&event_loop, host_address) {}
+
+AsyncProxy::AsyncProxy(EventLoop* event_loop, std::string const& host_address) : event_loop_(event_loop) {
+    std::lock_guard lock(mutex_);
+
+    tagger_.set_handler([this](ProxyTag const& tag, bool completed_successfully) {
+        handle_event(tag, completed_successfully);
+    });
+
+    grpc::ServerBuilder builder;
+    if (!host_address.empty()) {
+        builder.AddListeningPort(host_address, grpc::InsecureServerCredentials());
+    }
+    builder.RegisterAsyncGenericService(&service_);
+    owned_completion_queue_ = builder.AddCompletionQueue();
+    completion_queue_       = owned_completion_queue_.get();
+    server_                 = builder.BuildAndStart();
+
+    auto call_data     = std::make_unique<detail::AsyncProxyCall>(tagger_, service_, *completion_queue_);
+    auto raw_call_data = call_data.get();
+    rpc_call_data_.emplace(raw_call_data, std::move(call_data));
+
+    if (event_loop_) {
+        event_loop_->attach_server_queue(std::move(owned_completion_queue_));
+    }
+}
+
+auto AsyncProxy::grpc_server() -> grpc::Server& {
+    return *server_;
+}
+
+auto AsyncProxy::run() -> void {
+    if (event_loop_) {
+        return; // The event loop polls the queue.
+    }
+
+    void* raw_tag                = {};
+    bool  completed_successfully = {};
+
+    while (completion_queue_->Next(&raw_tag, &completed_successfully)) {
+        detail::complete(raw_tag, completed_successfully);
+    }
+}
+
+auto AsyncProxy::handle_event(ProxyTag const& tag, bool completed_successfully) -> void {
+    std::lock_guard lock(mutex_);
+
+    auto* call = static_cast<detail::AsyncProxyCall*>(tag.data);
+    call->process(tag.label, completed_successfully);
+
+    if (tag.label == ProxyTagLabel::NewCall) {
+        if (!completed_successfully) {
+            // The server is shutting down.
+            rpc_call_data_.erase(call);
+            return;
+        }
+        if (is_shutdown_) {
+            // The call is cancelled by the server and can't be forwarded anymore.
+            return;
+        }
+        {
+            auto  new_call     = call->clone();
+            auto* new_call_raw = new_call.get();
+            rpc_call_data_.emplace(new_call_raw, std::move(new_call));
+        }
+        call->start(stub(route(call->context())));
+    }
+
+    if (call->done()) {
+        rpc_call_data_.erase(call);
+    }
+}
+
+auto AsyncProxy::shutdown() -> void {
+    {
+        std::lock_guard lock(mutex_);
+        is_shutdown_ = true;
+        for (auto& [raw_call, call] : rpc_call_data_) {
+            call->shutdown();
+        }
+        server_->Shutdown();
+        completion_queue_->Shutdown();
+    }
+    if (event_loop_) {
+        // Handlers take the lock so it can't be held while the queue drains.
+        event_loop_->detach_server_queue(*completion_queue_);
+    }
+}
+
+auto AsyncProxy::route_method(std::string const& method_prefix, std::string const& backend_address) -> void {
+    std::lock_guard lock(mutex_);
+    method_routes_[method_prefix] = backend_address;
+}
+
+auto AsyncProxy::set_default_backend(std::string const& backend_address) -> void {
+    std::lock_guard lock(mutex_);
+    default_backend_ = backend_address;
+}
+
+auto AsyncProxy::set_router(ProxyRouter router) -> void {
+    std::lock_guard lock(mutex_);
+    router_ = std::move(router);
+}
+
+auto AsyncProxy::route(grpc::GenericServerContext const& context) const -> std::string {
+    if (router_) {
+        auto backend_address = router_(context);
+        if (!backend_address.empty()) {
+            return backend_address;
+        }
+    }
+
+    auto const& method = context.method();
+
+    // Prefixes of 'method' sort at or before it so the longest match is found walking backwards.
+    for (auto iter = method_routes_.upper_bound(method); iter != method_routes_.begin();) {
+        --iter;
+        if (method.compare(0u, iter->first.size(), iter->first) == 0) {
+            return iter->second;
+        }
+    }
+    return default_backend_;
+}
+
+auto AsyncProxy::stub(std::string const& backend_address) -> grpc::GenericStub* {
+    if (backend_address.empty()) {
+        return nullptr;
+    }
+    auto& backend_stub = stubs_[backend_address];
+    if (!backend_stub) {
+        backend_stub = std::make_unique<grpc::GenericStub>(
+            grpc::CreateChannel(backend_address, grpc::InsecureChannelCredentials()));
+    }
+    return backend_stub.get();
+}
+
+} // namespace ltb::net
@@ -0,0 +1,105 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// project
+#include "async_proxy_call.hpp"
+#include "ltb/net/event_loop.hpp"
+#include "ltb/net/tagger.hpp"
+
+// external
+#include <grpc++/generic/async_generic_service.h>
+#include <grpc++/generic/generic_stub.h>
+#include <grpc++/server.h>
+
+// standard
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace ltb::net {
+
+/// \brief Returns the address of the backend a call should be forwarded to, or an
+///        empty string to fall back to the method routes.
+using ProxyRouter = std::function<std::string(grpc::GenericServerContext const&)>;
+
+/// \brief A pass-through proxy that forwards every call to a backend without parsing it.
+///
+/// Unary and all streaming calls are forwarded as opaque byte buffers along with their
+/// metadata and deadline, and a call cancelled by its client is cancelled on the backend
+/// too. Calls are routed by 'set_router' first, then by the longest matching method
+/// prefix, then to the default backend. Calls without a route are finished with
+/// UNIMPLEMENTED.
+class AsyncProxy {
+public:
+    explicit AsyncProxy(std::string const& host_address);
+
+    /// \brief A proxy whose completion queue is polled by 'event_loop' so run() isn't needed
+    ///        (see AsyncServer).
+    explicit AsyncProxy(EventLoop& event_loop, std::string const& host_address);
+
+    auto grpc_server() -> grpc::Server&;
+
+    /// \brief Blocks the current thread (unless the proxy is attached to an EventLoop).
+    auto run() -> void;
+
+    auto shutdown() -> void;
+
+    /// \brief Routes methods starting with 'method_prefix' (e.g. "/package.Service/").
+    auto route_method(std::string const& method_prefix, std::string const& backend_address) -> void;
+
+    auto set_default_backend(std::string const& backend_address) -> void;
+
+    /// \brief Routes calls by their method and client metadata.
+    auto set_router(ProxyRouter router) -> void;
+
+private:
+    std::mutex                                   mutex_;
+    grpc::AsyncGenericService                    service_;
+    EventLoop*                                   event_loop_ = nullptr;
+    std::unique_ptr<grpc::ServerCompletionQueue> owned_completion_queue_;
+    grpc::ServerCompletionQueue*                 completion_queue_ = nullptr;
+    std::unique_ptr<grpc::Server>                server_;
+    bool                                         is_shutdown_ = false;
+
+    ProxyTagger tagger_;
+
+    ProxyRouter                        router_;
+    std::map<std::string, std::string> method_routes_;
+    std::string                        default_backend_;
+
+    std::unordered_map<std::string, std::unique_ptr<grpc::GenericStub>> stubs_; // Keyed by address
+
+    std::unordered_map<void*, std::unique_ptr<detail::AsyncProxyCall>> rpc_call_data_;
+
+    explicit AsyncProxy(EventLoop* event_loop, std::string const& host_address);
+
+    auto handle_event(ProxyTag const& tag, bool completed_successfully) -> void;
+
+    auto route(grpc::GenericServerContext const& context) const -> std::string;
+    auto stub(std::string const& backend_address) -> grpc::GenericStub*;
+};
+
+} // namespace ltb::net
@@ -0,0 +1,225 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "async_proxy_call.hpp"
+
+// standard
+#include <string>
+
+namespace ltb::net::detail {
+namespace {
+
+/// \brief Headers owned by the transport that are regenerated on each hop.
+auto is_forwarded(grpc::string_ref const& key) -> bool {
+    auto starts_with = [&key](grpc::string_ref const& prefix) {
+        return key.length() >= prefix.length() && key.substr(0u, prefix.length()) == prefix;
+    };
+    return !starts_with(":") && !starts_with("grpc-") && key != "te" && key != "content-type"
+        && key != "user-agent";
+}
+
+auto to_string(grpc::string_ref const& str) -> std::string {
+    return {str.data(), str.length()};
+}
+
+} // namespace
+
+AsyncProxyCall::AsyncProxyCall(ProxyTagger&                 tagger,
+                               grpc::AsyncGenericService&   service,
+                               grpc::ServerCompletionQueue& queue)
+    : tagger_(tagger),
+      service_(service),
+      completion_queue_(queue),
+      downstream_(&server_context_),
+      done_tag_(tagger_.make_tag(this, ProxyTagLabel::DownstreamDone)) {
+
+    // Tells the proxy when the client cancels so the backend call can be cancelled too.
+    server_context_.AsyncNotifyWhenDone(done_tag_);
+
+    service_.RequestCall(&server_context_,
+                         &downstream_,
+                         &completion_queue_,
+                         &completion_queue_,
+                         make_tag(ProxyTagLabel::NewCall));
+}
+
+AsyncProxyCall::~AsyncProxyCall() {
+    if (done_tag_) {
+        // The call never started (the server shut down) so gRPC won't return the tag.
+        tagger_.get_tag(done_tag_);
+    }
+}
+
+auto AsyncProxyCall::clone() -> std::unique_ptr<AsyncProxyCall> {
+    return std::make_unique<AsyncProxyCall>(tagger_, service_, completion_queue_);
+}
+
+auto AsyncProxyCall::context() const -> grpc::GenericServerContext const& {
+    return server_context_;
+}
+
+auto AsyncProxyCall::start(grpc::GenericStub* stub) -> void {
+    if (!stub) {
+        finish_downstream(grpc::Status{grpc::StatusCode::UNIMPLEMENTED, "No route for " + server_context_.method()});
+        return;
+    }
+
+    for (auto const& [key, value] : server_context_.client_metadata()) {
+        if (is_forwarded(key)) {
+            client_context_.AddMetadata(to_string(key), to_string(value));
+        }
+    }
+    client_context_.set_deadline(server_context_.deadline());
+
+    upstream_ = stub->PrepareCall(&client_context_, server_context_.method(), &completion_queue_);
+    upstream_->StartCall(make_tag(ProxyTagLabel::UpstreamStarted));
+}
+
+auto AsyncProxyCall::process(ProxyTagLabel label, bool completed_successfully) -> void {
+    --pending_operations_;
+
+    if (shutting_down_ && label != ProxyTagLabel::NewCall) {
+        // Nothing can be started on a queue that is shutting down.
+        return;
+    }
+
+    switch (label) {
+
+    case ProxyTagLabel::NewCall: {
+        if (completed_successfully) {
+            // gRPC now owns the done tag and returns it once the call is over.
+            ++pending_operations_;
+            done_tag_ = nullptr;
+        }
+    } break;
+
+    case ProxyTagLabel::UpstreamStarted: {
+        if (completed_successfully) {
+            upstream_->ReadInitialMetadata(make_tag(ProxyTagLabel::UpstreamInitialMetadata));
+            downstream_.Read(&downstream_message_, make_tag(ProxyTagLabel::DownstreamRead));
+        } else {
+            finish_upstream();
+        }
+    } break;
+
+    case ProxyTagLabel::DownstreamRead: {
+        if (upstream_finishing_) {
+            break;
+        }
+        if (completed_successfully) {
+            upstream_->Write(downstream_message_, make_tag(ProxyTagLabel::UpstreamWrite));
+        } else {
+            // The client has half-closed, or gone away which is handled by DownstreamDone.
+            upstream_->WritesDone(make_tag(ProxyTagLabel::UpstreamWritesDone));
+        }
+    } break;
+
+    case ProxyTagLabel::UpstreamWrite: {
+        if (completed_successfully && !upstream_finishing_) {
+            downstream_.Read(&downstream_message_, make_tag(ProxyTagLabel::DownstreamRead));
+        }
+    } break;
+
+    case ProxyTagLabel::UpstreamWritesDone: {
+    } break;
+
+    case ProxyTagLabel::UpstreamInitialMetadata: {
+        if (!completed_successfully) {
+            finish_upstream();
+            break;
+        }
+        for (auto const& [key, value] : client_context_.GetServerInitialMetadata()) {
+            if (is_forwarded(key)) {
+                server_context_.AddInitialMetadata(to_string(key), to_string(value));
+            }
+        }
+        upstream_->Read(&upstream_message_, make_tag(ProxyTagLabel::UpstreamRead));
+    } break;
+
+    case ProxyTagLabel::UpstreamRead: {
+        if (completed_successfully) {
+            downstream_.Write(upstream_message_, make_tag(ProxyTagLabel::DownstreamWrite));
+        } else {
+            finish_upstream();
+        }
+    } break;
+
+    case ProxyTagLabel::DownstreamWrite: {
+        if (completed_successfully) {
+            upstream_->Read(&upstream_message_, make_tag(ProxyTagLabel::UpstreamRead));
+        } else {
+            // The client is gone so there is nobody left to forward the rest of the call to.
+            client_context_.TryCancel();
+            finish_upstream();
+        }
+    } break;
+
+    case ProxyTagLabel::UpstreamFinish: {
+        for (auto const& [key, value] : client_context_.GetServerTrailingMetadata()) {
+            if (is_forwarded(key)) {
+                server_context_.AddTrailingMetadata(to_string(key), to_string(value));
+            }
+        }
+        finish_downstream(upstream_status_);
+    } break;
+
+    case ProxyTagLabel::DownstreamFinish: {
+        finished_ = true;
+    } break;
+
+    case ProxyTagLabel::DownstreamDone: {
+        if (server_context_.IsCancelled() && upstream_) {
+            client_context_.TryCancel();
+        }
+    } break;
+
+    } // end switch
+}
+
+auto AsyncProxyCall::shutdown() -> void {
+    shutting_down_ = true;
+    if (upstream_) {
+        client_context_.TryCancel();
+    }
+}
+
+auto AsyncProxyCall::done() const -> bool {
+    return (finished_ || shutting_down_) && pending_operations_ == 0u;
+}
+
+auto AsyncProxyCall::make_tag(ProxyTagLabel label) -> void* {
+    ++pending_operations_;
+    return tagger_.make_tag(this, label);
+}
+
+auto AsyncProxyCall::finish_upstream() -> void {
+    if (!upstream_finishing_) {
+        upstream_finishing_ = true;
+        upstream_->Finish(&upstream_status_, make_tag(ProxyTagLabel::UpstreamFinish));
+    }
+}
+
+auto AsyncProxyCall::finish_downstream(grpc::Status const& status) -> void {
+    downstream_.Finish(status, make_tag(ProxyTagLabel::DownstreamFinish));
+}
+
+} // namespace ltb::net::detail
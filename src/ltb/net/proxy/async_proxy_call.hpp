@@ -0,0 +1,91 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// project
+#include "ltb/net/tagger.hpp"
+
+// external
+#include <grpc++/generic/async_generic_service.h>
+#include <grpc++/generic/generic_stub.h>
+
+// standard
+#include <memory>
+
+namespace ltb::net::detail {
+
+/// \brief Forwards one call between a downstream client and an upstream backend.
+///
+/// Messages are pumped in both directions as opaque byte buffers. Each direction
+/// holds at most one message: the next read is only started once the previous
+/// message has been written, so gRPC flow control reaches from end to end.
+class AsyncProxyCall {
+public:
+    explicit AsyncProxyCall(ProxyTagger&                 tagger,
+                            grpc::AsyncGenericService&   service,
+                            grpc::ServerCompletionQueue& queue);
+    ~AsyncProxyCall();
+
+    auto clone() -> std::unique_ptr<AsyncProxyCall>;
+
+    [[nodiscard]] auto context() const -> grpc::GenericServerContext const&;
+
+    /// \brief Starts the upstream call, or finishes with UNIMPLEMENTED if 'stub' is null.
+    auto start(grpc::GenericStub* stub) -> void;
+
+    auto process(ProxyTagLabel label, bool completed_successfully) -> void;
+
+    /// \brief Cancels the upstream call and stops starting operations since the queue is
+    ///        shutting down. Pending operations still have to be processed.
+    auto shutdown() -> void;
+
+    /// \brief True once both sides have finished, or the proxy has shut down, and no
+    ///        operations are pending.
+    [[nodiscard]] auto done() const -> bool;
+
+private:
+    ProxyTagger&                 tagger_;
+    grpc::AsyncGenericService&   service_;
+    grpc::ServerCompletionQueue& completion_queue_;
+
+    grpc::GenericServerContext           server_context_;
+    grpc::GenericServerAsyncReaderWriter downstream_;
+    grpc::ByteBuffer                     downstream_message_;
+    void*                                done_tag_; ///< Only handed back by gRPC once the call has started
+
+    grpc::ClientContext                                   client_context_;
+    std::unique_ptr<grpc::GenericClientAsyncReaderWriter> upstream_;
+    grpc::ByteBuffer                                      upstream_message_;
+    grpc::Status                                          upstream_status_;
+
+    std::size_t pending_operations_ = 0u;
+    bool        upstream_finishing_ = false;
+    bool        finished_           = false;
+    bool        shutting_down_      = false;
+
+    auto make_tag(ProxyTagLabel label) -> void*;
+    auto finish_upstream() -> void;
+    auto finish_downstream(grpc::Status const& status) -> void;
+};
+
+} // namespace ltb::net::detail
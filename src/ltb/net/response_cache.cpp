@@ -0,0 +1,150 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "response_cache.hpp"
+
+// external
+#include <doctest/doctest.h>
+
+namespace ltb::net {
+
+ResponseCache::ResponseCache(ResponseCacheOptions options) : options_(options) {}
+
+auto ResponseCache::find(std::string const& key, Clock::time_point now) -> std::string const* {
+    auto iter = lookup_.find(key);
+    if (iter == lookup_.end()) {
+        return nullptr;
+    }
+
+    auto entry = iter->second;
+    if (entry->expires_at <= now) {
+        erase(entry);
+        return nullptr;
+    }
+
+    entries_.splice(entries_.begin(), entries_, entry);
+    return &entry->value;
+}
+
+auto ResponseCache::insert(std::string key, std::string value, Clock::time_point now) -> void {
+    auto iter = lookup_.find(key);
+    if (iter != lookup_.end()) {
+        erase(iter->second);
+    }
+
+    auto entry_bytes = key.size() + value.size();
+    if (options_.max_bytes > 0u && entry_bytes > options_.max_bytes) {
+        return;
+    }
+
+    entries_.push_front(Entry{std::move(key), std::move(value), now + options_.ttl});
+    lookup_.emplace(entries_.front().key, entries_.begin());
+    bytes_ += entry_bytes;
+
+    while ((options_.max_entries > 0u && entries_.size() > options_.max_entries)
+           || (options_.max_bytes > 0u && bytes_ > options_.max_bytes)) {
+        erase(std::prev(entries_.end()));
+    }
+}
+
+auto ResponseCache::erase(std::string const& key) -> bool {
+    auto iter = lookup_.find(key);
+    if (iter == lookup_.end()) {
+        return false;
+    }
+    erase(iter->second);
+    return true;
+}
+
+auto ResponseCache::clear() -> void {
+    lookup_.clear();
+    entries_.clear();
+    bytes_ = 0u;
+}
+
+auto ResponseCache::size() const -> std::size_t {
+    return entries_.size();
+}
+
+auto ResponseCache::bytes() const -> std::size_t {
+    return bytes_;
+}
+
+auto ResponseCache::erase(Entries::iterator entry) -> void {
+    bytes_ -= entry->key.size() + entry->value.size();
+    lookup_.erase(entry->key);
+    entries_.erase(entry);
+}
+
+TEST_CASE("[ltb][net] response_cache evicts expired and least recently used entries") {
+    using namespace std::chrono_literals;
+
+    ResponseCacheOptions options;
+    options.ttl         = 1s;
+    options.max_entries = 2u;
+    options.max_bytes   = 0u;
+
+    auto          now = ResponseCache::Clock::time_point{};
+    ResponseCache cache(options);
+
+    cache.insert("a", "1", now);
+    cache.insert("b", "2", now);
+    REQUIRE(cache.find("a", now));
+    CHECK(*cache.find("a", now) == "1");
+
+    // 'b' is the least recently used entry
+    cache.insert("c", "3", now);
+    CHECK(cache.size() == 2u);
+    CHECK(cache.find("b", now) == nullptr);
+    CHECK(cache.find("a", now) != nullptr);
+    CHECK(cache.find("c", now) != nullptr);
+
+    CHECK(cache.find("a", now + 1s) == nullptr);
+    CHECK(cache.size() == 1u);
+
+    CHECK(cache.erase("c"));
+    CHECK_FALSE(cache.erase("c"));
+    CHECK(cache.bytes() == 0u);
+}
+
+TEST_CASE("[ltb][net] response_cache stays within its byte limit") {
+    ResponseCacheOptions options;
+    options.max_entries = 0u;
+    options.max_bytes   = 10u;
+
+    auto          now = ResponseCache::Clock::time_point{};
+    ResponseCache cache(options);
+
+    cache.insert("k1", "abc", now);
+    cache.insert("k2", "abc", now);
+    CHECK(cache.bytes() == 10u);
+
+    cache.insert("k3", "abc", now);
+    CHECK(cache.bytes() == 10u);
+    CHECK(cache.find("k1", now) == nullptr);
+
+    // Too large to ever fit
+    cache.insert("k4", "0123456789", now);
+    CHECK(cache.find("k4", now) == nullptr);
+}
+
+} // namespace ltb::net
@@ -0,0 +1,78 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// project
+#include "ltb/util/duration.hpp"
+
+// standard
+#include <chrono>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace ltb::net {
+
+struct ResponseCacheOptions {
+    util::Duration ttl         = std::chrono::seconds(5);
+    std::size_t    max_entries = 1024u; ///< Zero means no limit on the number of entries.
+    std::size_t    max_bytes   = 16u * 1024u * 1024u; ///< Zero means no limit on memory used by keys and values.
+};
+
+/// \brief An LRU cache of serialized responses keyed on serialized requests.
+class ResponseCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit ResponseCache(ResponseCacheOptions options = {});
+
+    /// \brief Returns nullptr if there is no entry or it has expired. The pointer
+    ///        is only valid until the cache is next modified.
+    auto find(std::string const& key, Clock::time_point now) -> std::string const*;
+
+    auto insert(std::string key, std::string value, Clock::time_point now) -> void;
+    auto erase(std::string const& key) -> bool;
+    auto clear() -> void;
+
+    [[nodiscard]] auto size() const -> std::size_t;
+    [[nodiscard]] auto bytes() const -> std::size_t;
+
+private:
+    struct Entry {
+        std::string       key;
+        std::string       value;
+        Clock::time_point expires_at;
+    };
+    using Entries = std::list<Entry>;
+
+    ResponseCacheOptions options_;
+    std::size_t          bytes_ = 0u;
+
+    Entries                                                 entries_; // Most recently used first
+    std::unordered_map<std::string_view, Entries::iterator> lookup_;
+
+    auto erase(Entries::iterator entry) -> void;
+};
+
+} // namespace ltb::net
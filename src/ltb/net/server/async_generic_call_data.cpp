@@ -0,0 +1,77 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "async_generic_call_data.hpp"
+
+namespace ltb::net::detail {
+
+GenericServerWriterData::GenericServerWriterData() : stream(&context) {}
+
+auto GenericServerWriterData::cancel() -> void {
+    context.TryCancel();
+}
+
+auto GenericServerWriterData::finish(grpc::ByteBuffer const& response, grpc::Status status, void* tag) -> void {
+    if (status.ok()) {
+        stream.WriteAndFinish(response, grpc::WriteOptions{}, status, tag);
+    } else {
+        stream.Finish(status, tag);
+    }
+}
+
+AsyncGenericCallData::AsyncGenericCallData(ServerTagger&                tagger,
+                                           grpc::AsyncGenericService&   service,
+                                           grpc::ServerCompletionQueue& queue)
+    : tagger_(tagger),
+      service_(service),
+      completion_queue_(queue),
+      writer_data_(std::make_shared<GenericServerWriterData>()) {
+
+    service_.RequestCall(&writer_data_->context,
+                         &writer_data_->stream,
+                         &completion_queue_,
+                         &completion_queue_,
+                         tagger_.make_tag(this, ServerTagLabel::NewRpc));
+}
+
+auto AsyncGenericCallData::clone() -> std::unique_ptr<AsyncGenericCallData> {
+    return std::make_unique<AsyncGenericCallData>(tagger_, service_, completion_queue_);
+}
+
+auto AsyncGenericCallData::read_request() -> void {
+    writer_data_->stream.Read(&request_, tagger_.make_tag(this, ServerTagLabel::Reading));
+}
+
+auto AsyncGenericCallData::method() const -> std::string const& {
+    return writer_data_->context.method();
+}
+
+auto AsyncGenericCallData::invoke_connection_callback(GenericUnaryConnect const& on_connect) -> void {
+    auto tag = tagger_.make_tag(this, ServerTagLabel::Done);
+    if (on_connect) {
+        on_connect(writer_data_->context, request_, AsyncServerUnaryWriter<grpc::ByteBuffer>{writer_data_, tag});
+    } else {
+        writer_data_->stream.Finish(grpc::Status{grpc::StatusCode::UNIMPLEMENTED, "RPC not implemented."}, tag);
+    }
+}
+
+} // namespace ltb::net::detail
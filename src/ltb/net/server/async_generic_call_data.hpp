@@ -0,0 +1,77 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// project
+#include "async_server_callbacks.hpp"
+#include "async_server_unary_writer.hpp"
+#include "ltb/net/tagger.hpp"
+
+// external
+#include <grpc++/generic/async_generic_service.h>
+
+// standard
+#include <memory>
+
+namespace ltb::net::detail {
+
+struct GenericServerWriterData : public AsyncServerUnaryWriterData<grpc::ByteBuffer> {
+    explicit GenericServerWriterData();
+    ~GenericServerWriterData() override = default;
+
+    auto cancel() -> void override;
+    auto finish(grpc::ByteBuffer const& response, grpc::Status status, void* tag) -> void override;
+
+    grpc::GenericServerContext           context;
+    grpc::GenericServerAsyncReaderWriter stream;
+};
+
+/// \brief A unary call to any method received through an AsyncGenericService.
+///
+/// Every call is treated as unary: one request message is read and one
+/// response is written with the final status.
+class AsyncGenericCallData {
+public:
+    explicit AsyncGenericCallData(ServerTagger&                tagger,
+                                  grpc::AsyncGenericService&   service,
+                                  grpc::ServerCompletionQueue& queue);
+
+    auto clone() -> std::unique_ptr<AsyncGenericCallData>;
+
+    /// \brief Reads the request once the call has arrived.
+    auto read_request() -> void;
+
+    [[nodiscard]] auto method() const -> std::string const&;
+
+    auto invoke_connection_callback(GenericUnaryConnect const& on_connect) -> void;
+
+private:
+    ServerTagger&                tagger_;
+    grpc::AsyncGenericService&   service_;
+    grpc::ServerCompletionQueue& completion_queue_;
+
+    grpc::ByteBuffer                         request_;
+    std::shared_ptr<GenericServerWriterData> writer_data_;
+};
+
+} // namespace ltb::net::detail
@@ -0,0 +1,148 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "async_generic_server.hpp"
+
+// external
+#include <grpc++/server_builder.h>
+
+// standard
+#include <iostream>
+
+namespace ltb::net {
+
+AsyncGenericServer::AsyncGenericServer(std::string const& host_address)
+    : AsyncGenericServer(nullptr, host_address) {}
+
+AsyncGenericServer::AsyncGenericServer(EventLoop& event_loop, std::string const& host_address)
+    : AsyncGenericServer(&event_loop, host_address) {}
+
+AsyncGenericServer::AsyncGenericServer(EventLoop* event_loop, std::string const& host_address)
+    : event_loop_(event_loop) {
+    std::lock_guard lock(mutex_);
+
+    tagger_.set_handler([this](ServerTag const& tag, bool completed_successfully) {
+        handle_event(tag, completed_successfully);
+    });
+
+    grpc::ServerBuilder builder;
+    if (!host_address.empty()) {
+        builder.AddListeningPort(host_address, grpc::InsecureServerCredentials());
+    }
+    builder.RegisterAsyncGenericService(&service_);
+    owned_completion_queue_ = builder.AddCompletionQueue();
+    completion_queue_       = owned_completion_queue_.get();
+    server_                 = builder.BuildAndStart();
+
+    auto call_data     = std::make_unique<detail::AsyncGenericCallData>(tagger_, service_, *completion_queue_);
+    auto raw_call_data = call_data.get();
+    rpc_call_data_.emplace(raw_call_data, std::move(call_data));
+
+    if (event_loop_) {
+        event_loop_->attach_server_queue(std::move(owned_completion_queue_));
+    }
+}
+
+auto AsyncGenericServer::grpc_server() -> grpc::Server& {
+    return *server_;
+}
+
+auto AsyncGenericServer::run() -> void {
+    if (event_loop_) {
+        return; // The event loop polls the queue.
+    }
+
+    void* raw_tag                = {};
+    bool  completed_successfully = {};
+
+    while (completion_queue_->Next(&raw_tag, &completed_successfully)) {
+        detail::complete(raw_tag, completed_successfully);
+    }
+}
+
+auto AsyncGenericServer::handle_event(ServerTag const& tag, bool completed_successfully) -> void {
+    std::lock_guard lock(mutex_);
+
+    std::cout << "S: " << (completed_successfully ? "Success: " : "Failure: ") << tag << std::endl;
+
+    if (completed_successfully) {
+        auto* rpc = static_cast<detail::AsyncGenericCallData*>(tag.data);
+
+        switch (tag.label) {
+
+        case ServerTagLabel::NewRpc: {
+            {
+                auto  new_rpc     = rpc->clone();
+                auto* new_rpc_raw = new_rpc.get();
+                rpc_call_data_.emplace(new_rpc_raw, std::move(new_rpc));
+            }
+            rpc->read_request();
+
+        } break;
+
+        case ServerTagLabel::Reading: {
+            rpc->invoke_connection_callback(find_handler(rpc->method()));
+        } break;
+
+        case ServerTagLabel::Writing:
+        case ServerTagLabel::Resume: {
+        } break;
+
+        case ServerTagLabel::Done: {
+            rpc_call_data_.erase(rpc);
+        } break;
+
+        } // end switch
+
+    } else {
+        rpc_call_data_.erase(tag.data);
+    }
+}
+
+auto AsyncGenericServer::shutdown() -> void {
+    {
+        std::lock_guard lock(mutex_);
+        server_->Shutdown();
+        completion_queue_->Shutdown();
+    }
+    if (event_loop_) {
+        // Handlers take the lock so it can't be held while the queue drains.
+        event_loop_->detach_server_queue(*completion_queue_);
+    }
+}
+
+auto AsyncGenericServer::register_method(std::string const& method_name, GenericUnaryConnect on_connect) -> void {
+    std::lock_guard lock(mutex_);
+    methods_[method_name] = std::move(on_connect);
+}
+
+auto AsyncGenericServer::register_fallback(GenericUnaryConnect on_connect) -> void {
+    std::lock_guard lock(mutex_);
+    fallback_ = std::move(on_connect);
+}
+
+auto AsyncGenericServer::find_handler(std::string const& method_name) const -> GenericUnaryConnect const& {
+    auto iter = methods_.find(method_name);
+    return (iter != methods_.end() ? iter->second : fallback_);
+}
+
+} // namespace ltb::net
@@ -0,0 +1,89 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// project
+#include "async_generic_call_data.hpp"
+#include "ltb/net/event_loop.hpp"
+#include "ltb/net/tagger.hpp"
+
+// external
+#include <grpc++/generic/async_generic_service.h>
+#include <grpc++/server.h>
+
+// standard
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace ltb::net {
+
+/// \brief A server that receives raw grpc::ByteBuffer payloads for any method name.
+///
+/// Calls are dispatched by their full method name ("/package.Service/Method") so services
+/// that are unknown at compile time can be handled, and payloads are only parsed if a
+/// handler chooses to.
+class AsyncGenericServer {
+public:
+    explicit AsyncGenericServer(std::string const& host_address);
+
+    /// \brief A server whose completion queue is polled by 'event_loop' so run() isn't needed
+    ///        (see AsyncServer).
+    explicit AsyncGenericServer(EventLoop& event_loop, std::string const& host_address);
+
+    auto grpc_server() -> grpc::Server&;
+
+    /// \brief Blocks the current thread (unless the server is attached to an EventLoop).
+    auto run() -> void;
+
+    auto shutdown() -> void;
+
+    auto register_method(std::string const& method_name, GenericUnaryConnect on_connect) -> void;
+
+    /// \brief Handles calls to methods without a registered handler. They are
+    ///        finished with UNIMPLEMENTED if this is not set.
+    auto register_fallback(GenericUnaryConnect on_connect) -> void;
+
+private:
+    std::mutex                                   mutex_;
+    grpc::AsyncGenericService                    service_;
+    EventLoop*                                   event_loop_ = nullptr;
+    std::unique_ptr<grpc::ServerCompletionQueue> owned_completion_queue_;
+    grpc::ServerCompletionQueue*                 completion_queue_ = nullptr;
+    std::unique_ptr<grpc::Server>                server_;
+
+    ServerTagger tagger_;
+
+    std::unordered_map<std::string, GenericUnaryConnect> methods_;
+    GenericUnaryConnect                                  fallback_;
+
+    std::unordered_map<void*, std::unique_ptr<detail::AsyncGenericCallData>> rpc_call_data_;
+
+    explicit AsyncGenericServer(EventLoop* event_loop, std::string const& host_address);
+
+    auto handle_event(ServerTag const& tag, bool completed_successfully) -> void;
+
+    auto find_handler(std::string const& method_name) const -> GenericUnaryConnect const&;
+};
+
+} // namespace ltb::net
@@ -0,0 +1,50 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// standard
+#include <type_traits>
+
+namespace ltb::net::detail {
+
+/// \brief The number of generated 'WithAsyncMethod_' wrappers around a base service.
+template <typename Service>
+struct AsyncMethodDepth : std::integral_constant<int, 0> {};
+
+template <template <typename> class WithAsyncMethod, typename BaseService>
+struct AsyncMethodDepth<WithAsyncMethod<BaseService>>
+    : std::integral_constant<int, 1 + AsyncMethodDepth<BaseService>::value> {};
+
+/// \brief The index gRPC uses for the method declared by 'BaseService'.
+///
+/// Generated async services wrap the base service once per method with the first method
+/// outermost (AsyncService = WithAsyncMethod_a<WithAsyncMethod_b<...<Service>>>), so the
+/// index is the number of wrappers above the one that declares the method.
+template <typename Service, typename BaseService>
+constexpr auto async_method_index() -> int {
+    static_assert(std::is_base_of<BaseService, Service>::value, "BaseService must be a base class of Service");
+    static_assert(AsyncMethodDepth<Service>::value > 0, "Service must be a generated AsyncService");
+    return AsyncMethodDepth<Service>::value - AsyncMethodDepth<BaseService>::value;
+}
+
+} // namespace ltb::net::detail
@@ -24,8 +24,12 @@
 
 // project
 #include "async_server_rpc.hpp"
+#include "async_server_stats.hpp"
+#include "async_stream_call_data.hpp"
 #include "async_unary_call_data.hpp"
+#include "ltb/net/event_loop.hpp"
 #include "ltb/net/tagger.hpp"
+#include "unary_rpc_options.hpp"
 
 // external
 #include <grpc++/server.h>
@@ -34,6 +38,7 @@
 // standard
 #include <functional>
 #include <unordered_map>
+#include <vector>
 
 namespace ltb::net {
 
@@ -42,49 +47,105 @@ class AsyncServer {
 public:
     explicit AsyncServer(std::string const& host_address);
 
+    /// \brief A server whose completion queue is polled by 'event_loop' so run() isn't needed.
+    explicit AsyncServer(EventLoop& event_loop, std::string const& host_address);
+
     auto grpc_server() -> grpc::Server&;
 
-    /// \brief Blocks the current thread.
+    /// \brief Blocks the current thread (unless the server is attached to an EventLoop).
     auto run() -> void;
 
     auto shutdown() -> void;
 
+    auto stats() -> AsyncServerStats;
+
     template <typename BaseService, typename Request, typename Response>
     auto register_rpc(UnaryAsyncRpc<BaseService, Request, Response>             unary_call_ptr,
                       typename ServerCallbacks<Request, Response>::UnaryConnect on_connect,
-                      DisconnectCallback                                        on_disconnect = nullptr) -> void;
+                      DisconnectCallback                                        on_disconnect = nullptr,
+                      UnaryRpcOptions const&                                    options       = {}) -> void;
+
+    /// \brief Registers a raw method with a typed handler that can finish with pre-serialized responses.
+    ///
+    /// 'raw_call_ptr' is a method of a service wrapped with the generated WithRawMethod_ templates.
+    /// Requests that fail to parse are finished with INVALID_ARGUMENT without invoking the handler.
+    template <typename Request, typename Response, typename BaseService>
+    auto register_serialized_rpc(
+        UnaryAsyncRpc<BaseService, grpc::ByteBuffer, grpc::ByteBuffer>      raw_call_ptr,
+        typename ServerCallbacks<Request, Response>::SerializedUnaryConnect on_connect,
+        DisconnectCallback                                                  on_disconnect = nullptr,
+        UnaryRpcOptions const&                                              options       = {}) -> void;
 
     template <typename BaseService, typename Request, typename Response>
-    auto register_rpc(ClientStreamAsyncRpc<BaseService, Request, Response> call_ptr) -> void;
+    auto register_rpc(ClientStreamAsyncRpc<BaseService, Request, Response>             call_ptr,
+                      typename ServerCallbacks<Request, Response>::ClientStreamConnect on_connect    = nullptr,
+                      DisconnectCallback                                               on_disconnect = nullptr) -> void;
 
     template <typename BaseService, typename Request, typename Response>
-    auto register_rpc(ServerStreamAsyncRpc<BaseService, Request, Response> call_ptr) -> void;
+    auto register_rpc(ServerStreamAsyncRpc<BaseService, Request, Response>             call_ptr,
+                      typename ServerCallbacks<Request, Response>::ServerStreamConnect on_connect    = nullptr,
+                      DisconnectCallback                                               on_disconnect = nullptr) -> void;
 
     template <typename BaseService, typename Request, typename Response>
-    auto register_rpc(BidirectionalStreamAsyncRpc<BaseService, Request, Response> call_ptr) -> void;
+    auto register_rpc(BidirectionalStreamAsyncRpc<BaseService, Request, Response>             call_ptr,
+                      typename ServerCallbacks<Request, Response>::BidirectionalStreamConnect on_connect = nullptr,
+                      DisconnectCallback on_disconnect = nullptr) -> void;
 
 private:
     std::mutex                                   mutex_;
     Service                                      service_;
-    std::unique_ptr<grpc::ServerCompletionQueue> completion_queue_;
+    EventLoop*                                   event_loop_ = nullptr;
+    std::unique_ptr<grpc::ServerCompletionQueue> owned_completion_queue_;
+    grpc::ServerCompletionQueue*                 completion_queue_ = nullptr;
     std::unique_ptr<grpc::Server>                server_;
 
     ServerTagger tagger_;
 
     std::unordered_map<void*, std::unique_ptr<detail::AsyncServerRpc<Service>>> rpc_call_data_;
+
+    // Shared with the call data of pure methods.
+    std::vector<std::shared_ptr<detail::ShardedResponseCache>> response_caches_;
+
+    template <typename BaseService,
+              typename Request,
+              typename Response,
+              typename Stream,
+              typename StreamRpc,
+              typename Connect>
+    auto register_stream_rpc(StreamRpc call_ptr, Connect on_connect, DisconnectCallback on_disconnect) -> void;
+
+    explicit AsyncServer(EventLoop* event_loop, std::string const& host_address);
+
+    auto handle_event(ServerTag const& tag, bool completed_successfully) -> void;
 };
 
 template <typename Service>
-AsyncServer<Service>::AsyncServer(std::string const& host_address) {
+AsyncServer<Service>::AsyncServer(std::string const& host_address) : AsyncServer(nullptr, host_address) {}
+
+template <typename Service>
+AsyncServer<Service>::AsyncServer(EventLoop& event_loop, std::string const& host_address)
+    : AsyncServer(&event_loop, host_address) {}
+
+template <typename Service>
+AsyncServer<Service>::AsyncServer(EventLoop* event_loop, std::string const& host_address) : event_loop_(event_loop) {
     std::lock_guard lock(mutex_);
 
+    tagger_.set_handler([this](ServerTag const& tag, bool completed_successfully) {
+        handle_event(tag, completed_successfully);
+    });
+
     grpc::ServerBuilder builder;
     if (!host_address.empty()) {
         builder.AddListeningPort(host_address, grpc::InsecureServerCredentials());
     }
     builder.RegisterService(&service_);
-    completion_queue_ = builder.AddCompletionQueue();
-    server_           = builder.BuildAndStart();
+    owned_completion_queue_ = builder.AddCompletionQueue();
+    completion_queue_       = owned_completion_queue_.get();
+    server_                 = builder.BuildAndStart();
+
+    if (event_loop_) {
+        event_loop_->attach_server_queue(std::move(owned_completion_queue_));
+    }
 }
 
 template <typename Service>
@@ -94,97 +155,215 @@ auto AsyncServer<Service>::grpc_server() -> grpc::Server& {
 
 template <typename Service>
 auto AsyncServer<Service>::run() -> void {
+    if (event_loop_) {
+        return; // The event loop polls the queue.
+    }
+
     void* raw_tag                = {};
     bool  completed_successfully = {};
 
     while (completion_queue_->Next(&raw_tag, &completed_successfully)) {
-        std::lock_guard lock(mutex_);
+        detail::complete(raw_tag, completed_successfully);
+    }
+}
+
+template <typename Service>
+auto AsyncServer<Service>::handle_event(ServerTag const& tag, bool completed_successfully) -> void {
+    std::lock_guard lock(mutex_);
 
-        auto tag = tagger_.get_tag(raw_tag);
-        std::cout << "S: " << (completed_successfully ? "Success: " : "Failure: ") << tag << std::endl;
+    std::cout << "S: " << (completed_successfully ? "Success: " : "Failure: ") << tag << std::endl;
 
-        if (completed_successfully) {
-            switch (tag.label) {
+    if (tag.label == ServerTagLabel::Resume) {
+        // Coroutines see failed operations through the awaited result.
+        static_cast<detail::AsyncServerAwaitable*>(tag.data)->resume(completed_successfully);
+        return;
+    }
 
-            case ServerTagLabel::NewRpc: {
-                auto* rpc = static_cast<detail::AsyncServerRpc<Service>*>(tag.data);
-                {
-                    auto  new_rpc     = rpc->clone();
-                    auto* new_rpc_raw = new_rpc.get();
-                    rpc_call_data_.emplace(new_rpc_raw, std::move(new_rpc));
-                }
-                rpc->invoke_connection_callback();
+    if (completed_successfully) {
+        switch (tag.label) {
 
-            } break;
+        case ServerTagLabel::NewRpc: {
+            auto* rpc = static_cast<detail::AsyncServerRpc<Service>*>(tag.data);
+            {
+                auto  new_rpc     = rpc->clone();
+                auto* new_rpc_raw = new_rpc.get();
+                rpc_call_data_.emplace(new_rpc_raw, std::move(new_rpc));
+            }
+            rpc->invoke_connection_callback();
 
-            case ServerTagLabel::Writing: {
-            } break;
+        } break;
 
-            case ServerTagLabel::Done: {
-                auto* rpc = static_cast<detail::AsyncServerRpc<Service>*>(tag.data);
-                rpc->invoke_disconnect_callback();
-                rpc_call_data_.erase(rpc);
-            } break;
+        case ServerTagLabel::Reading:
+        case ServerTagLabel::Writing:
+        case ServerTagLabel::Resume: {
+        } break;
 
-            } // end switch
+        case ServerTagLabel::Done: {
+            auto* rpc = static_cast<detail::AsyncServerRpc<Service>*>(tag.data);
+            rpc->invoke_disconnect_callback();
+            rpc_call_data_.erase(rpc);
+        } break;
 
-        } else {
-            rpc_call_data_.erase(tag.data);
-        }
+        } // end switch
+
+    } else {
+        rpc_call_data_.erase(tag.data);
     }
 }
 
 template <typename Service>
 auto AsyncServer<Service>::shutdown() -> void {
+    {
+        std::lock_guard lock(mutex_);
+        server_->Shutdown();
+        completion_queue_->Shutdown();
+    }
+    if (event_loop_) {
+        // Handlers take the lock so it can't be held while the queue drains.
+        event_loop_->detach_server_queue(*completion_queue_);
+    }
+}
+
+template <typename Service>
+auto AsyncServer<Service>::stats() -> AsyncServerStats {
     std::lock_guard lock(mutex_);
-    server_->Shutdown();
-    completion_queue_->Shutdown();
+
+    AsyncServerStats stats;
+    for (auto const& response_cache : response_caches_) {
+        auto cache_stats = response_cache->stats();
+        stats.response_cache.hits += cache_stats.hits;
+        stats.response_cache.misses += cache_stats.misses;
+        stats.response_cache.entries += cache_stats.entries;
+        stats.response_cache.bytes += cache_stats.bytes;
+    }
+    return stats;
 }
 
 template <typename Service>
 template <typename BaseService, typename Request, typename Response>
 auto AsyncServer<Service>::register_rpc(UnaryAsyncRpc<BaseService, Request, Response>             unary_call_ptr,
                                         typename ServerCallbacks<Request, Response>::UnaryConnect on_connect,
-                                        DisconnectCallback on_disconnect) -> void {
+                                        DisconnectCallback     on_disconnect,
+                                        UnaryRpcOptions const& options) -> void {
     std::lock_guard lock(mutex_);
 
     static_assert(std::is_base_of<BaseService, Service>::value, "BaseService must be a base class of Service");
 
+    auto coalescer = (options.coalesce_identical_requests
+                          ? std::make_shared<detail::UnaryRequestCoalescer<Response>>()
+                          : nullptr);
+
+    auto response_cache = (options.pure ? std::make_shared<detail::ShardedResponseCache>(options.response_cache,
+                                                                                         options.response_cache_shards)
+                                        : nullptr);
+    if (response_cache) {
+        response_caches_.emplace_back(response_cache);
+    }
+
+    // The call data is keyed on Service so methods declared by any of its bases can be registered.
     auto unary_call_data
-        = std::make_unique<detail::AsyncServerUnaryCallData<BaseService, Request, Response>>(tagger_,
-                                                                                             *completion_queue_,
-                                                                                             std::move(on_disconnect),
-                                                                                             service_,
-                                                                                             unary_call_ptr,
-                                                                                             std::move(on_connect));
+        = std::make_unique<detail::AsyncServerUnaryCallData<Service, Request, Response>>(tagger_,
+                                                                                         *completion_queue_,
+                                                                                         std::move(on_disconnect),
+                                                                                         service_,
+                                                                                         unary_call_ptr,
+                                                                                         std::move(on_connect),
+                                                                                         std::move(coalescer),
+                                                                                         std::move(response_cache));
 
     auto raw_unary_call_data = unary_call_data.get();
     rpc_call_data_.emplace(raw_unary_call_data, std::move(unary_call_data));
 }
 
 template <typename Service>
-template <typename BaseService, typename Request, typename Response>
-auto AsyncServer<Service>::register_rpc(ClientStreamAsyncRpc<BaseService, Request, Response> /*call_ptr*/) -> void {
-    std::lock_guard lock(mutex_);
+template <typename Request, typename Response, typename BaseService>
+auto AsyncServer<Service>::register_serialized_rpc(
+    UnaryAsyncRpc<BaseService, grpc::ByteBuffer, grpc::ByteBuffer>      raw_call_ptr,
+    typename ServerCallbacks<Request, Response>::SerializedUnaryConnect on_connect,
+    DisconnectCallback                                                  on_disconnect,
+    UnaryRpcOptions const&                                              options) -> void {
+
+    auto on_raw_connect = [on_connect = std::move(on_connect)](grpc::ByteBuffer const&                  raw_request,
+                                                               AsyncServerUnaryWriter<grpc::ByteBuffer> writer) {
+        // Deserialization consumes the buffer so it works on a (shallow) copy.
+        auto    buffer  = raw_request;
+        Request request = {};
+        auto    status  = grpc::SerializationTraits<Request>::Deserialize(&buffer, &request);
+
+        if (!status.ok()) {
+            writer.finish({}, grpc::Status{grpc::StatusCode::INVALID_ARGUMENT, status.error_message()});
+        } else if (on_connect) {
+            on_connect(request, AsyncServerSerializedWriter<Response>{std::move(writer)});
+        } else {
+            writer.finish({}, grpc::Status{grpc::StatusCode::UNIMPLEMENTED, "RPC not implemented."});
+        }
+    };
 
-    static_assert(std::is_base_of<BaseService, Service>::value, "BaseService must be a base class of Service");
+    register_rpc(raw_call_ptr,
+                 typename ServerCallbacks<grpc::ByteBuffer, grpc::ByteBuffer>::UnaryConnect(std::move(on_raw_connect)),
+                 std::move(on_disconnect),
+                 options);
 }
 
 template <typename Service>
 template <typename BaseService, typename Request, typename Response>
-auto AsyncServer<Service>::register_rpc(ServerStreamAsyncRpc<BaseService, Request, Response> /*call_ptr*/) -> void {
-    std::lock_guard lock(mutex_);
+auto AsyncServer<Service>::register_rpc(ClientStreamAsyncRpc<BaseService, Request, Response>             call_ptr,
+                                        typename ServerCallbacks<Request, Response>::ClientStreamConnect on_connect,
+                                        DisconnectCallback on_disconnect) -> void {
+    register_stream_rpc<BaseService, Request, Response, grpc_impl::ServerAsyncReader<Response, Request>>(
+        call_ptr,
+        std::move(on_connect),
+        std::move(on_disconnect));
+}
 
-    static_assert(std::is_base_of<BaseService, Service>::value, "BaseService must be a base class of Service");
+template <typename Service>
+template <typename BaseService, typename Request, typename Response>
+auto AsyncServer<Service>::register_rpc(ServerStreamAsyncRpc<BaseService, Request, Response>             call_ptr,
+                                        typename ServerCallbacks<Request, Response>::ServerStreamConnect on_connect,
+                                        DisconnectCallback on_disconnect) -> void {
+    register_stream_rpc<BaseService, Request, Response, grpc_impl::ServerAsyncWriter<Response>>(
+        call_ptr,
+        std::move(on_connect),
+        std::move(on_disconnect));
 }
 
 template <typename Service>
 template <typename BaseService, typename Request, typename Response>
-auto AsyncServer<Service>::register_rpc(BidirectionalStreamAsyncRpc<BaseService, Request, Response> /*call_ptr*/)
-    -> void {
+auto AsyncServer<Service>::register_rpc(
+    BidirectionalStreamAsyncRpc<BaseService, Request, Response>             call_ptr,
+    typename ServerCallbacks<Request, Response>::BidirectionalStreamConnect on_connect,
+    DisconnectCallback                                                      on_disconnect) -> void {
+    register_stream_rpc<BaseService, Request, Response, grpc_impl::ServerAsyncReaderWriter<Response, Request>>(
+        call_ptr,
+        std::move(on_connect),
+        std::move(on_disconnect));
+}
+
+template <typename Service>
+template <typename BaseService,
+          typename Request,
+          typename Response,
+          typename Stream,
+          typename StreamRpc,
+          typename Connect>
+auto AsyncServer<Service>::register_stream_rpc(StreamRpc          call_ptr,
+                                               Connect            on_connect,
+                                               DisconnectCallback on_disconnect) -> void {
     std::lock_guard lock(mutex_);
 
     static_assert(std::is_base_of<BaseService, Service>::value, "BaseService must be a base class of Service");
+
+    using CallData = detail::AsyncServerStreamCallData<Service, Request, Response, Stream, StreamRpc, Connect>;
+
+    auto stream_call_data = std::make_unique<CallData>(tagger_,
+                                                       *completion_queue_,
+                                                       std::move(on_disconnect),
+                                                       service_,
+                                                       call_ptr,
+                                                       std::move(on_connect));
+
+    auto raw_stream_call_data = stream_call_data.get();
+    rpc_call_data_.emplace(raw_stream_call_data, std::move(stream_call_data));
 }
 
 } // namespace ltb::net
@@ -0,0 +1,49 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+namespace ltb::net::detail {
+
+/// \brief The part of a stream awaitable the server's completion queue loop resumes.
+///
+/// The coroutine handle is type-erased so the server itself still compiles as C++17.
+/// A pointer to the awaitable is the data of its ServerTagLabel::Resume tag.
+struct AsyncServerAwaitable {
+    auto resume(bool completed_successfully) -> void {
+        ok = completed_successfully;
+        resume_coroutine(coroutine);
+    }
+
+    void* coroutine                 = nullptr;
+    void (*resume_coroutine)(void*) = nullptr;
+    bool ok                         = false;
+
+protected:
+    template <typename CoroutineHandle>
+    auto suspend(CoroutineHandle handle) -> void {
+        coroutine        = handle.address();
+        resume_coroutine = [](void* address) { CoroutineHandle::from_address(address).resume(); };
+    }
+};
+
+} // namespace ltb::net::detail
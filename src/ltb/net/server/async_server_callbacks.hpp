@@ -23,8 +23,13 @@
 #pragma once
 
 // project
+#include "async_server_serialized_writer.hpp"
+#include "async_server_stream.hpp"
 #include "async_server_unary_writer.hpp"
 
+// external
+#include <grpc++/generic/async_generic_service.h>
+
 // standard
 #include <functional>
 
@@ -32,8 +37,20 @@ namespace ltb::net {
 
 template <typename Request, typename Response>
 struct ServerCallbacks {
-    using UnaryConnect = std::function<void(Request const&, AsyncServerUnaryWriter<Response>)>;
+    using UnaryConnect           = std::function<void(Request const&, AsyncServerUnaryWriter<Response>)>;
+    using SerializedUnaryConnect = std::function<void(Request const&, AsyncServerSerializedWriter<Response>)>;
+
+    // Streaming handlers are coroutines (see ltb/net/coro/server_task.hpp).
+    using ClientStreamConnect        = std::function<void(AsyncServerReader<Request, Response>)>;
+    using ServerStreamConnect        = std::function<void(Request const&, AsyncServerWriter<Request, Response>)>;
+    using BidirectionalStreamConnect = std::function<void(AsyncServerReaderWriter<Request, Response>)>;
 };
 using DisconnectCallback = std::function<void(ClientID const&)>;
 
+/// \brief Handles a unary call to any method with its raw payload.
+///
+/// The context provides the method name, deadline and client metadata.
+using GenericUnaryConnect = std::function<
+    void(grpc::GenericServerContext const&, grpc::ByteBuffer const&, AsyncServerUnaryWriter<grpc::ByteBuffer>)>;
+
 } // namespace ltb::net
@@ -0,0 +1,82 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// project
+#include "async_server_unary_writer.hpp"
+#include "serialized_response.hpp"
+
+namespace ltb::net {
+
+/// \brief Finishes a raw (grpc::ByteBuffer) unary call with a typed or pre-serialized response.
+template <typename Response>
+struct AsyncServerSerializedWriter {
+public:
+    explicit AsyncServerSerializedWriter(AsyncServerUnaryWriter<grpc::ByteBuffer> writer);
+
+    auto cancel() -> void;
+
+    /// \brief Serializes 'response' and writes it.
+    auto finish(Response const& response, grpc::Status status) -> void;
+
+    /// \brief Writes the already serialized 'response' without copying it.
+    ///
+    /// The call finishes with the serialization error instead if 'response' couldn't be serialized.
+    auto finish(SerializedResponse<Response> const& response, grpc::Status status) -> void;
+
+    [[nodiscard]] auto client_id() const -> ClientID const&;
+
+private:
+    AsyncServerUnaryWriter<grpc::ByteBuffer> writer_;
+};
+
+template <typename Response>
+AsyncServerSerializedWriter<Response>::AsyncServerSerializedWriter(AsyncServerUnaryWriter<grpc::ByteBuffer> writer)
+    : writer_(std::move(writer)) {}
+
+template <typename Response>
+auto AsyncServerSerializedWriter<Response>::cancel() -> void {
+    writer_.cancel();
+}
+
+template <typename Response>
+auto AsyncServerSerializedWriter<Response>::finish(Response const& response, grpc::Status status) -> void {
+    finish(SerializedResponse<Response>(response), std::move(status));
+}
+
+template <typename Response>
+auto AsyncServerSerializedWriter<Response>::finish(SerializedResponse<Response> const& response, grpc::Status status)
+    -> void {
+    if (!response.status().ok()) {
+        writer_.finish({}, response.status());
+        return;
+    }
+    writer_.finish(response.buffer(), std::move(status));
+}
+
+template <typename Response>
+auto AsyncServerSerializedWriter<Response>::client_id() const -> ClientID const& {
+    return writer_.client_id();
+}
+
+} // namespace ltb::net
@@ -0,0 +1,178 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// project
+#include "async_server_awaitable.hpp"
+#include "async_server_unary_writer.hpp"
+#include "ltb/net/tagger.hpp"
+
+// external
+#include <grpc++/server_context.h>
+
+// standard
+#include <optional>
+#include <type_traits>
+
+namespace ltb::net {
+namespace detail {
+
+template <typename Stream>
+struct AsyncServerStreamData {
+    explicit AsyncServerStreamData() : stream(&context) {}
+
+    grpc::ServerContext context;
+    Stream              stream;
+    // ^  grpc_impl::ServerAsyncReader<Response, Request>
+    // or grpc_impl::ServerAsyncWriter<Response>
+    // or grpc_impl::ServerAsyncReaderWriter<Response, Request>
+};
+
+template <typename Request, typename Stream>
+struct ReadAwaitable : public AsyncServerAwaitable {
+    explicit ReadAwaitable(Stream& s, ServerTagger& t) : stream(s), tagger(t) {}
+
+    auto await_ready() const -> bool { return false; }
+
+    template <typename CoroutineHandle>
+    auto await_suspend(CoroutineHandle handle) -> void {
+        this->suspend(handle);
+        stream.Read(&request, tagger.make_tag(this, ServerTagLabel::Resume));
+    }
+
+    auto await_resume() -> std::optional<Request> {
+        return (this->ok ? std::optional<Request>(std::move(request)) : std::nullopt);
+    }
+
+    Stream&       stream;
+    ServerTagger& tagger;
+    Request       request = {};
+};
+
+template <typename Response, typename Stream>
+struct WriteAwaitable : public AsyncServerAwaitable {
+    explicit WriteAwaitable(Stream& s, ServerTagger& t, Response const& r) : stream(s), tagger(t), response(r) {}
+
+    auto await_ready() const -> bool { return false; }
+
+    template <typename CoroutineHandle>
+    auto await_suspend(CoroutineHandle handle) -> void {
+        this->suspend(handle);
+        stream.Write(response, tagger.make_tag(this, ServerTagLabel::Resume));
+    }
+
+    auto await_resume() const -> bool { return this->ok; }
+
+    Stream&         stream;
+    ServerTagger&   tagger;
+    Response const& response;
+};
+
+} // namespace detail
+
+/// \brief The server side of a streaming call, used from a coroutine handler.
+///
+/// 'co_await read()' and 'co_await write()' suspend the handler until the
+/// operation completes and resume it on the server's completion queue thread.
+/// Only the operations the call's shape supports will compile:
+///   - client streaming: read(), finish(response, status)
+///   - server streaming: write(), finish(status)
+///   - bidirectional:    read(), write(), finish(status)
+template <typename Request, typename Response, typename Stream>
+class AsyncServerStream {
+public:
+    explicit AsyncServerStream(std::shared_ptr<detail::AsyncServerStreamData<Stream>> data,
+                               ServerTagger&                                          tagger,
+                               void*                                                  tag);
+
+    /// \brief Yields the next request, or std::nullopt once the client has finished writing.
+    auto read() -> detail::ReadAwaitable<Request, Stream>;
+
+    /// \brief Yields false if the call is gone. 'response' must outlive the co_await.
+    auto write(Response const& response) -> detail::WriteAwaitable<Response, Stream>;
+
+    auto finish(grpc::Status status) -> void;
+    auto finish(Response const& response, grpc::Status status) -> void; ///< Client streaming only
+
+    auto               cancel() -> void;
+    [[nodiscard]] auto client_id() const -> ClientID const&;
+
+private:
+    // Shared with the call so the stream outlives it if the handler is still suspended.
+    std::shared_ptr<detail::AsyncServerStreamData<Stream>> data_;
+    ServerTagger&                                          tagger_;
+    void*                                                  tag_;
+};
+
+template <typename Request, typename Response, typename Stream>
+AsyncServerStream<Request, Response, Stream>::AsyncServerStream(
+    std::shared_ptr<detail::AsyncServerStreamData<Stream>> data, ServerTagger& tagger, void* tag)
+    : data_(std::move(data)), tagger_(tagger), tag_(tag) {}
+
+template <typename Request, typename Response, typename Stream>
+auto AsyncServerStream<Request, Response, Stream>::read() -> detail::ReadAwaitable<Request, Stream> {
+    return detail::ReadAwaitable<Request, Stream>{data_->stream, tagger_};
+}
+
+template <typename Request, typename Response, typename Stream>
+auto AsyncServerStream<Request, Response, Stream>::write(Response const& response)
+    -> detail::WriteAwaitable<Response, Stream> {
+    return detail::WriteAwaitable<Response, Stream>{data_->stream, tagger_, response};
+}
+
+template <typename Request, typename Response, typename Stream>
+auto AsyncServerStream<Request, Response, Stream>::finish(grpc::Status status) -> void {
+    if constexpr (std::is_same_v<Stream, grpc_impl::ServerAsyncReader<Response, Request>>) {
+        // Client streaming calls can only finish without a response if they fail.
+        data_->stream.FinishWithError(status, tag_);
+    } else {
+        data_->stream.Finish(status, tag_);
+    }
+}
+
+template <typename Request, typename Response, typename Stream>
+auto AsyncServerStream<Request, Response, Stream>::finish(Response const& response, grpc::Status status) -> void {
+    data_->stream.Finish(response, status, tag_);
+}
+
+template <typename Request, typename Response, typename Stream>
+auto AsyncServerStream<Request, Response, Stream>::cancel() -> void {
+    data_->context.TryCancel();
+}
+
+template <typename Request, typename Response, typename Stream>
+auto AsyncServerStream<Request, Response, Stream>::client_id() const -> ClientID const& {
+    return tag_;
+}
+
+template <typename Request, typename Response>
+using AsyncServerReader = AsyncServerStream<Request, Response, grpc_impl::ServerAsyncReader<Response, Request>>;
+
+template <typename Request, typename Response>
+using AsyncServerWriter = AsyncServerStream<Request, Response, grpc_impl::ServerAsyncWriter<Response>>;
+
+template <typename Request, typename Response>
+using AsyncServerReaderWriter
+    = AsyncServerStream<Request, Response, grpc_impl::ServerAsyncReaderWriter<Response, Request>>;
+
+} // namespace ltb::net
@@ -36,9 +36,9 @@ namespace detail {
 
 template <typename Response>
 struct AsyncServerUnaryWriterData {
-    virtual ~AsyncServerUnaryWriterData()                                          = 0;
-    virtual auto cancel() -> void                                                  = 0;
-    virtual auto finish(Response response, grpc::Status status, void* tag) -> void = 0;
+    virtual ~AsyncServerUnaryWriterData()                                                 = 0;
+    virtual auto cancel() -> void                                                         = 0;
+    virtual auto finish(Response const& response, grpc::Status status, void* tag) -> void = 0;
 };
 
 template <typename Response>
@@ -50,7 +50,7 @@ struct TypedAsyncServerUnaryWriterData : public AsyncServerUnaryWriterData<Respo
     ~TypedAsyncServerUnaryWriterData() override = default;
 
     auto cancel() -> void override { context.TryCancel(); }
-    auto finish(Response response, grpc::Status status, void* tag) -> void override {
+    auto finish(Response const& response, grpc::Status status, void* tag) -> void override {
         writer.Finish(response, status, tag);
     }
 
@@ -75,7 +75,7 @@ public:
     explicit AsyncServerUnaryWriter(std::weak_ptr<detail::AsyncServerUnaryWriterData<Response>> data, void* tag);
 
     auto               cancel() -> void;
-    auto               finish(Response response, grpc::Status status) -> void;
+    auto               finish(Response const& response, grpc::Status status) -> void;
     [[nodiscard]] auto client_id() const -> ClientID const&;
 
 private:
@@ -96,7 +96,7 @@ auto AsyncServerUnaryWriter<Response>::cancel() -> void {
 }
 
 template <typename Response>
-auto AsyncServerUnaryWriter<Response>::finish(Response response, grpc::Status status) -> void {
+auto AsyncServerUnaryWriter<Response>::finish(Response const& response, grpc::Status status) -> void {
     if (auto data = data_.lock()) {
         data->finish(response, status, tag_);
     }
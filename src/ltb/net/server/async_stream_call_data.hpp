@@ -0,0 +1,120 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// project
+#include "async_server_rpc.hpp"
+#include "async_server_stream.hpp"
+#include "ltb/net/tagger.hpp"
+#include "rpc_function_types.hpp"
+
+// standard
+#include <type_traits>
+
+namespace ltb::net::detail {
+
+/// \brief A client streaming, server streaming or bidirectional call handled by a coroutine.
+template <typename Service, typename Request, typename Response, typename Stream, typename StreamRpc, typename Connect>
+struct AsyncServerStreamCallData : public AsyncServerRpc<Service> {
+
+    explicit AsyncServerStreamCallData(ServerTagger&                tagger,
+                                       grpc::ServerCompletionQueue& queue,
+                                       DisconnectCallback           on_disconnect,
+                                       Service&                     service,
+                                       StreamRpc                    stream_call,
+                                       Connect                      on_connect);
+
+    ~AsyncServerStreamCallData() override = default;
+
+    auto clone() -> std::unique_ptr<AsyncServerRpc<Service>> override;
+    auto invoke_connection_callback() -> void override;
+
+private:
+    // Only server streaming calls start with a request.
+    static constexpr bool has_initial_request = std::is_same_v<Stream, grpc_impl::ServerAsyncWriter<Response>>;
+
+    StreamRpc                                      stream_call_;
+    Request                                        request_;
+    std::shared_ptr<AsyncServerStreamData<Stream>> stream_data_;
+    Connect                                        on_connect_;
+};
+
+template <typename Service, typename Request, typename Response, typename Stream, typename StreamRpc, typename Connect>
+AsyncServerStreamCallData<Service, Request, Response, Stream, StreamRpc, Connect>::AsyncServerStreamCallData(
+    ServerTagger&                tagger,
+    grpc::ServerCompletionQueue& queue,
+    DisconnectCallback           on_disconnect,
+    Service&                     service,
+    StreamRpc                    stream_call,
+    Connect                      on_connect)
+
+    : AsyncServerRpc<Service>(tagger, queue, service, std::move(on_disconnect)),
+      stream_call_(stream_call),
+      stream_data_(std::make_shared<AsyncServerStreamData<Stream>>()),
+      on_connect_(std::move(on_connect)) {
+
+    auto tag = this->tagger_.make_tag(this, ServerTagLabel::NewRpc);
+
+    if constexpr (has_initial_request) {
+        (service.*stream_call)(&stream_data_->context,
+                               &request_,
+                               &stream_data_->stream,
+                               &this->completion_queue_,
+                               &this->completion_queue_,
+                               tag);
+    } else {
+        (service.*stream_call)(&stream_data_->context,
+                               &stream_data_->stream,
+                               &this->completion_queue_,
+                               &this->completion_queue_,
+                               tag);
+    }
+}
+
+template <typename Service, typename Request, typename Response, typename Stream, typename StreamRpc, typename Connect>
+auto AsyncServerStreamCallData<Service, Request, Response, Stream, StreamRpc, Connect>::clone()
+    -> std::unique_ptr<AsyncServerRpc<Service>> {
+    return std::make_unique<AsyncServerStreamCallData>(this->tagger_,
+                                                       this->completion_queue_,
+                                                       this->on_disconnect_,
+                                                       this->service_,
+                                                       stream_call_,
+                                                       on_connect_);
+}
+
+template <typename Service, typename Request, typename Response, typename Stream, typename StreamRpc, typename Connect>
+auto AsyncServerStreamCallData<Service, Request, Response, Stream, StreamRpc, Connect>::invoke_connection_callback()
+    -> void {
+    auto tag = this->tagger_.make_tag(this, ServerTagLabel::Done);
+    auto stream = AsyncServerStream<Request, Response, Stream>{stream_data_, this->tagger_, tag};
+
+    if (!on_connect_) {
+        stream.finish(grpc::Status{grpc::StatusCode::UNIMPLEMENTED, "RPC not implemented."});
+    } else if constexpr (has_initial_request) {
+        on_connect_(request_, std::move(stream));
+    } else {
+        on_connect_(std::move(stream));
+    }
+}
+
+} // namespace ltb::net::detail
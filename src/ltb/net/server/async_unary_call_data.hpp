@@ -27,6 +27,7 @@
 #include "async_server_unary_writer.hpp"
 #include "ltb/net/tagger.hpp"
 #include "rpc_function_types.hpp"
+#include "unary_request_dispatch.hpp"
 
 namespace ltb::net::detail {
 
@@ -38,7 +39,9 @@ struct AsyncServerUnaryCallData : public AsyncServerRpc<Service> {
                                       DisconnectCallback                                        on_disconnect,
                                       Service&                                                  service,
                                       UnaryAsyncRpc<Service, Request, Response>                 unary_call,
-                                      typename ServerCallbacks<Request, Response>::UnaryConnect on_connect);
+                                      typename ServerCallbacks<Request, Response>::UnaryConnect on_connect,
+                                      std::shared_ptr<UnaryRequestCoalescer<Response>>          coalescer,
+                                      std::shared_ptr<ShardedResponseCache>                     response_cache);
 
     ~AsyncServerUnaryCallData() override = default;
 
@@ -50,6 +53,13 @@ private:
     Request                                                   request_;
     std::shared_ptr<ServerAsyncResponseWriter<Response>>      writer_data_;
     typename ServerCallbacks<Request, Response>::UnaryConnect on_connect_;
+
+    // Null unless identical requests are coalesced or responses are cached.
+    std::shared_ptr<UnaryRequestCoalescer<Response>> coalescer_;
+    std::shared_ptr<ShardedResponseCache>            response_cache_;
+
+    // The (possibly wrapped) 'writer_data_' given to the handler.
+    std::shared_ptr<AsyncServerUnaryWriterData<Response>> handler_writer_data_;
 };
 
 template <typename Service, typename Request, typename Response>
@@ -59,12 +69,16 @@ AsyncServerUnaryCallData<Service, Request, Response>::AsyncServerUnaryCallData(
     DisconnectCallback                                        on_disconnect,
     Service&                                                  service,
     UnaryAsyncRpc<Service, Request, Response>                 unary_call,
-    typename ServerCallbacks<Request, Response>::UnaryConnect on_connect)
+    typename ServerCallbacks<Request, Response>::UnaryConnect on_connect,
+    std::shared_ptr<UnaryRequestCoalescer<Response>>          coalescer,
+    std::shared_ptr<ShardedResponseCache>                     response_cache)
 
     : AsyncServerRpc<Service>(tagger, queue, service, std::move(on_disconnect)),
       unary_call_(unary_call),
       writer_data_(std::make_shared<ServerAsyncResponseWriter<Response>>()),
-      on_connect_(std::move(on_connect)) {
+      on_connect_(std::move(on_connect)),
+      coalescer_(std::move(coalescer)),
+      response_cache_(std::move(response_cache)) {
 
     (service.*unary_call)(&writer_data_->context,
                           &request_,
@@ -81,14 +95,21 @@ auto AsyncServerUnaryCallData<Service, Request, Response>::clone() -> std::uniqu
                                                                                   this->on_disconnect_,
                                                                                   this->service_,
                                                                                   unary_call_,
-                                                                                  on_connect_);
+                                                                                  on_connect_,
+                                                                                  coalescer_,
+                                                                                  response_cache_);
 }
 
 template <typename Service, typename Request, typename Response>
 auto AsyncServerUnaryCallData<Service, Request, Response>::invoke_connection_callback() -> void {
     auto tag = this->tagger_.make_tag(this, ServerTagLabel::Done);
     if (on_connect_) {
-        on_connect_(request_, AsyncServerUnaryWriter<Response>{writer_data_, tag});
+        handler_writer_data_ = dispatch_unary_request<Request, Response>(request_,
+                                                                          writer_data_,
+                                                                          tag,
+                                                                          on_connect_,
+                                                                          coalescer_,
+                                                                          response_cache_);
     } else {
         writer_data_->writer.FinishWithError(grpc::Status{grpc::StatusCode::UNIMPLEMENTED, "RPC not implemented."},
                                              tag);
@@ -0,0 +1,74 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// project
+#include "async_server_unary_writer.hpp"
+#include "message_bytes.hpp"
+#include "sharded_response_cache.hpp"
+
+// standard
+#include <memory>
+#include <string>
+
+namespace ltb::net::detail {
+
+/// \brief The writer data handed to the handler of a pure method.
+///
+/// Successful responses are stored in the method's cache before being written.
+template <typename Response>
+struct CachingUnaryWriterData : public AsyncServerUnaryWriterData<Response> {
+    explicit CachingUnaryWriterData(std::shared_ptr<ShardedResponseCache>                 response_cache,
+                                    std::string                                           request_key,
+                                    std::shared_ptr<AsyncServerUnaryWriterData<Response>> writer_data);
+    ~CachingUnaryWriterData() override = default;
+
+    auto cancel() -> void override;
+    auto finish(Response const& response, grpc::Status status, void* tag) -> void override;
+
+    std::shared_ptr<ShardedResponseCache>                 cache;
+    std::string                                           key;
+    std::shared_ptr<AsyncServerUnaryWriterData<Response>> writer;
+};
+
+template <typename Response>
+CachingUnaryWriterData<Response>::CachingUnaryWriterData(
+    std::shared_ptr<ShardedResponseCache>                 response_cache,
+    std::string                                           request_key,
+    std::shared_ptr<AsyncServerUnaryWriterData<Response>> writer_data)
+    : cache(std::move(response_cache)), key(std::move(request_key)), writer(std::move(writer_data)) {}
+
+template <typename Response>
+auto CachingUnaryWriterData<Response>::cancel() -> void {
+    writer->cancel();
+}
+
+template <typename Response>
+auto CachingUnaryWriterData<Response>::finish(Response const& response, grpc::Status status, void* tag) -> void {
+    if (status.ok()) {
+        cache->insert(key, to_bytes(response), ShardedResponseCache::Clock::now());
+    }
+    writer->finish(response, status, tag);
+}
+
+} // namespace ltb::net::detail
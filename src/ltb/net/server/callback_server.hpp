@@ -0,0 +1,193 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// project
+#include "async_method_index.hpp"
+#include "async_server_stats.hpp"
+#include "callback_unary_reactor.hpp"
+#include "rpc_function_types.hpp"
+#include "unary_rpc_options.hpp"
+
+// external
+#include <grpc++/server.h>
+#include <grpc++/server_builder.h>
+
+// standard
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace ltb::net {
+namespace detail {
+
+/// \brief Exposes the protected method registration of a generated service.
+template <typename Service>
+class CallbackService : public Service {
+public:
+    using Service::MarkMethodCallback;
+};
+
+} // namespace detail
+
+/// \brief An alternative to AsyncServer built on gRPC's callback (reactor) API.
+///
+/// Unary rpcs are registered exactly as they are with an AsyncServer, using the methods of
+/// the generated AsyncService, but gRPC invokes the handlers on its own thread pool instead
+/// of a completion queue thread, so they may run concurrently. Methods have to be registered
+/// before the server starts, which happens on the first call to run() or grpc_server().
+/// Methods that are not registered are never answered, so calls to them end at their deadline.
+template <typename Service>
+class CallbackServer {
+public:
+    explicit CallbackServer(std::string const& host_address);
+
+    /// \brief Starts the server if it has not been started yet.
+    auto grpc_server() -> grpc::Server&;
+
+    /// \brief Starts the server if needed and blocks the current thread until it is shut down.
+    auto run() -> void;
+
+    auto shutdown() -> void;
+
+    auto stats() -> AsyncServerStats;
+
+    template <typename BaseService, typename Request, typename Response>
+    auto register_rpc(UnaryAsyncRpc<BaseService, Request, Response>             unary_call_ptr,
+                      typename ServerCallbacks<Request, Response>::UnaryConnect on_connect,
+                      DisconnectCallback                                        on_disconnect = nullptr,
+                      UnaryRpcOptions const&                                    options       = {}) -> void;
+
+private:
+    std::mutex                       mutex_;
+    detail::CallbackService<Service> service_;
+    grpc::ServerBuilder              builder_;
+    std::unique_ptr<grpc::Server>    server_;
+    bool                             shut_down_ = false;
+
+    // Shared with the handlers of pure methods.
+    std::vector<std::shared_ptr<detail::ShardedResponseCache>> response_caches_;
+
+    auto start() -> grpc::Server&;
+};
+
+template <typename Service>
+CallbackServer<Service>::CallbackServer(std::string const& host_address) {
+    if (!host_address.empty()) {
+        builder_.AddListeningPort(host_address, grpc::InsecureServerCredentials());
+    }
+}
+
+template <typename Service>
+auto CallbackServer<Service>::grpc_server() -> grpc::Server& {
+    std::lock_guard lock(mutex_);
+    return start();
+}
+
+template <typename Service>
+auto CallbackServer<Service>::run() -> void {
+    grpc::Server* server = nullptr;
+    {
+        std::lock_guard lock(mutex_);
+        if (shut_down_) {
+            return;
+        }
+        server = &start();
+    }
+    server->Wait();
+}
+
+template <typename Service>
+auto CallbackServer<Service>::shutdown() -> void {
+    std::lock_guard lock(mutex_);
+    shut_down_ = true;
+    if (server_) {
+        server_->Shutdown();
+    }
+}
+
+template <typename Service>
+auto CallbackServer<Service>::stats() -> AsyncServerStats {
+    std::lock_guard lock(mutex_);
+
+    AsyncServerStats stats;
+    for (auto const& response_cache : response_caches_) {
+        auto cache_stats = response_cache->stats();
+        stats.response_cache.hits += cache_stats.hits;
+        stats.response_cache.misses += cache_stats.misses;
+        stats.response_cache.entries += cache_stats.entries;
+        stats.response_cache.bytes += cache_stats.bytes;
+    }
+    return stats;
+}
+
+template <typename Service>
+template <typename BaseService, typename Request, typename Response>
+auto CallbackServer<Service>::register_rpc(UnaryAsyncRpc<BaseService, Request, Response> /*unary_call_ptr*/,
+                                           typename ServerCallbacks<Request, Response>::UnaryConnect on_connect,
+                                           DisconnectCallback     on_disconnect,
+                                           UnaryRpcOptions const& options) -> void {
+    std::lock_guard lock(mutex_);
+
+    if (server_) {
+        throw std::logic_error("CallbackServer rpcs must be registered before the server starts");
+    }
+
+    auto coalescer = (options.coalesce_identical_requests
+                          ? std::make_shared<detail::UnaryRequestCoalescer<Response>>()
+                          : nullptr);
+
+    auto response_cache = (options.pure ? std::make_shared<detail::ShardedResponseCache>(options.response_cache,
+                                                                                         options.response_cache_shards)
+                                        : nullptr);
+    if (response_cache) {
+        response_caches_.emplace_back(response_cache);
+    }
+
+    auto handler = [on_connect     = std::move(on_connect),
+                    on_disconnect  = std::move(on_disconnect),
+                    coalescer      = std::move(coalescer),
+                    response_cache = std::move(response_cache)](grpc::CallbackServerContext* context,
+                                                                Request const*               request,
+                                                                Response*                    response) {
+        auto* reactor = new detail::CallbackUnaryReactor<Request, Response>(*context, *response, on_disconnect);
+        reactor->start(*request, on_connect, coalescer, response_cache);
+        return static_cast<grpc::ServerUnaryReactor*>(reactor);
+    };
+
+    // The service takes ownership of the handler.
+    service_.MarkMethodCallback(detail::async_method_index<Service, BaseService>(),
+                                new grpc::internal::CallbackUnaryHandler<Request, Response>(std::move(handler)));
+}
+
+template <typename Service>
+auto CallbackServer<Service>::start() -> grpc::Server& {
+    if (!server_) {
+        builder_.RegisterService(&service_);
+        server_ = builder_.BuildAndStart();
+    }
+    return *server_;
+}
+
+} // namespace ltb::net
@@ -0,0 +1,161 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// project
+#include "async_server_callbacks.hpp"
+#include "async_server_unary_writer.hpp"
+#include "unary_request_dispatch.hpp"
+
+// external
+#include <grpc++/server_context.h>
+#include <grpcpp/impl/codegen/server_callback_handlers.h>
+
+// standard
+#include <memory>
+#include <mutex>
+
+namespace ltb::net::detail {
+
+/// \brief Writes the response of a unary call made through the callback API.
+///
+/// Handlers may finish from any thread, and finishing after the call is done does nothing.
+template <typename Response>
+struct ReactorUnaryWriterData : public AsyncServerUnaryWriterData<Response> {
+    explicit ReactorUnaryWriterData(grpc::CallbackServerContext& server_context,
+                                    grpc::ServerUnaryReactor&    unary_reactor,
+                                    Response&                    response_out);
+    ~ReactorUnaryWriterData() override = default;
+
+    auto cancel() -> void override;
+    auto finish(Response const& response, grpc::Status status, void* tag) -> void override;
+
+    /// \brief Called once gRPC is done with the call.
+    auto done() -> void;
+
+    std::mutex                   mutex;
+    grpc::CallbackServerContext& context;
+    grpc::ServerUnaryReactor&    reactor;
+    Response&                    response_buffer; ///< Owned by gRPC until the call is done
+    bool                         finished = false;
+};
+
+/// \brief The reactor of one unary call handled by a CallbackServer.
+///
+/// It deletes itself once gRPC is done with the call.
+template <typename Request, typename Response>
+class CallbackUnaryReactor : public grpc::ServerUnaryReactor {
+public:
+    explicit CallbackUnaryReactor(grpc::CallbackServerContext& context,
+                                  Response&                    response,
+                                  DisconnectCallback const&    on_disconnect);
+    ~CallbackUnaryReactor() override = default;
+
+    auto start(Request const&                                                   request,
+               typename ServerCallbacks<Request, Response>::UnaryConnect const& on_connect,
+               std::shared_ptr<UnaryRequestCoalescer<Response>> const&          coalescer,
+               std::shared_ptr<ShardedResponseCache> const&                     response_cache) -> void;
+
+    auto OnDone() -> void override;
+
+private:
+    std::shared_ptr<ReactorUnaryWriterData<Response>> writer_data_;
+    DisconnectCallback                                on_disconnect_;
+
+    // The (possibly wrapped) 'writer_data_' given to the handler.
+    std::shared_ptr<AsyncServerUnaryWriterData<Response>> handler_writer_data_;
+};
+
+template <typename Response>
+ReactorUnaryWriterData<Response>::ReactorUnaryWriterData(grpc::CallbackServerContext& server_context,
+                                                         grpc::ServerUnaryReactor&    unary_reactor,
+                                                         Response&                    response_out)
+    : context(server_context), reactor(unary_reactor), response_buffer(response_out) {}
+
+template <typename Response>
+auto ReactorUnaryWriterData<Response>::cancel() -> void {
+    std::lock_guard lock(mutex);
+    if (!finished) {
+        context.TryCancel();
+    }
+}
+
+template <typename Response>
+auto ReactorUnaryWriterData<Response>::finish(Response const& response, grpc::Status status, void* /*tag*/)
+    -> void {
+    std::lock_guard lock(mutex);
+    if (finished) {
+        return;
+    }
+    finished = true;
+
+    if (status.ok()) {
+        response_buffer = response;
+    }
+    reactor.Finish(std::move(status));
+}
+
+template <typename Response>
+auto ReactorUnaryWriterData<Response>::done() -> void {
+    std::lock_guard lock(mutex);
+    finished = true;
+}
+
+template <typename Request, typename Response>
+CallbackUnaryReactor<Request, Response>::CallbackUnaryReactor(grpc::CallbackServerContext& context,
+                                                              Response&                    response,
+                                                              DisconnectCallback const&    on_disconnect)
+    : writer_data_(std::make_shared<ReactorUnaryWriterData<Response>>(context, *this, response)),
+      on_disconnect_(on_disconnect) {}
+
+template <typename Request, typename Response>
+auto CallbackUnaryReactor<Request, Response>::start(
+    Request const&                                                   request,
+    typename ServerCallbacks<Request, Response>::UnaryConnect const& on_connect,
+    std::shared_ptr<UnaryRequestCoalescer<Response>> const&          coalescer,
+    std::shared_ptr<ShardedResponseCache> const&                     response_cache) -> void {
+
+    if (on_connect) {
+        handler_writer_data_ = dispatch_unary_request<Request, Response>(request,
+                                                                          writer_data_,
+                                                                          this,
+                                                                          on_connect,
+                                                                          coalescer,
+                                                                          response_cache);
+    } else {
+        writer_data_->finish({}, grpc::Status{grpc::StatusCode::UNIMPLEMENTED, "RPC not implemented."}, this);
+    }
+}
+
+template <typename Request, typename Response>
+auto CallbackUnaryReactor<Request, Response>::OnDone() -> void {
+    writer_data_->done();
+
+    // Matches the completion queue engine which only reports calls that finished.
+    if (on_disconnect_ && !writer_data_->context.IsCancelled()) {
+        on_disconnect_(this);
+    }
+    delete this;
+}
+
+} // namespace ltb::net::detail
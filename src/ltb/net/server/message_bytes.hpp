@@ -0,0 +1,68 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// external
+#include <grpc++/support/byte_buffer.h>
+
+// standard
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ltb::net::detail {
+
+/// \brief The serialized form of a protobuf message or the contents of a raw grpc::ByteBuffer.
+template <typename Message>
+auto to_bytes(Message const& message) -> std::string {
+    if constexpr (std::is_same_v<Message, grpc::ByteBuffer>) {
+        std::vector<grpc::Slice> slices;
+        message.Dump(&slices);
+
+        std::string bytes;
+        bytes.reserve(message.Length());
+        for (auto const& slice : slices) {
+            bytes.append(reinterpret_cast<char const*>(slice.begin()), slice.size());
+        }
+        return bytes;
+
+    } else {
+        return message.SerializeAsString();
+    }
+}
+
+/// \brief The inverse of to_bytes. A grpc::ByteBuffer is filled without parsing.
+template <typename Message>
+auto from_bytes(std::string const& bytes) -> Message {
+    if constexpr (std::is_same_v<Message, grpc::ByteBuffer>) {
+        grpc::Slice slice(bytes);
+        return grpc::ByteBuffer(&slice, 1u);
+
+    } else {
+        Message message;
+        message.ParseFromString(bytes);
+        return message;
+    }
+}
+
+} // namespace ltb::net::detail
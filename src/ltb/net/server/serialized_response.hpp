@@ -0,0 +1,69 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// external
+#include <grpc++/impl/codegen/serialization_traits.h>
+#include <grpc++/support/byte_buffer.h>
+#include <grpc++/support/status.h>
+
+namespace ltb::net {
+
+/// \brief A response serialized once so it can be written to any number of calls.
+///
+/// Copies share the underlying slices, so writing one never serializes or copies the payload.
+template <typename Response>
+class SerializedResponse {
+public:
+    explicit SerializedResponse(Response const& response);
+
+    [[nodiscard]] auto buffer() const -> grpc::ByteBuffer const&;
+
+    /// \brief Not OK if 'response' couldn't be serialized, in which case the buffer is empty.
+    [[nodiscard]] auto status() const -> grpc::Status const&;
+
+private:
+    grpc::ByteBuffer buffer_;
+    grpc::Status     status_;
+};
+
+template <typename Response>
+SerializedResponse<Response>::SerializedResponse(Response const& response) {
+    bool own_buffer = false;
+    status_         = grpc::SerializationTraits<Response>::Serialize(response, &buffer_, &own_buffer);
+    if (!status_.ok()) {
+        buffer_.Clear();
+    }
+}
+
+template <typename Response>
+auto SerializedResponse<Response>::buffer() const -> grpc::ByteBuffer const& {
+    return buffer_;
+}
+
+template <typename Response>
+auto SerializedResponse<Response>::status() const -> grpc::Status const& {
+    return status_;
+}
+
+} // namespace ltb::net
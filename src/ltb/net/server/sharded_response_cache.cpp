@@ -0,0 +1,114 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "sharded_response_cache.hpp"
+
+// external
+#include <doctest/doctest.h>
+
+// standard
+#include <algorithm>
+#include <functional>
+
+namespace ltb::net::detail {
+namespace {
+
+auto divided_limit(std::size_t limit, std::size_t shard_count) -> std::size_t {
+    // Zero means "no limit" so a non-zero limit never rounds down to zero.
+    return (limit == 0u ? 0u : std::max<std::size_t>(1u, limit / shard_count));
+}
+
+} // namespace
+
+ShardedResponseCache::Shard::Shard(ResponseCacheOptions options) : cache(options) {}
+
+ShardedResponseCache::ShardedResponseCache(ResponseCacheOptions options, std::size_t shard_count) {
+    shard_count         = std::max<std::size_t>(1u, shard_count);
+    options.max_entries = divided_limit(options.max_entries, shard_count);
+    options.max_bytes   = divided_limit(options.max_bytes, shard_count);
+
+    shards_.reserve(shard_count);
+    for (auto i = 0u; i < shard_count; ++i) {
+        shards_.emplace_back(std::make_unique<Shard>(options));
+    }
+}
+
+auto ShardedResponseCache::find(std::string const& key, Clock::time_point now) -> std::optional<std::string> {
+    auto&           key_shard = shard(key);
+    std::lock_guard lock(key_shard.mutex);
+
+    if (auto const* value = key_shard.cache.find(key, now)) {
+        ++key_shard.hits;
+        return *value;
+    }
+    ++key_shard.misses;
+    return std::nullopt;
+}
+
+auto ShardedResponseCache::insert(std::string key, std::string value, Clock::time_point now) -> void {
+    auto&           key_shard = shard(key);
+    std::lock_guard lock(key_shard.mutex);
+    key_shard.cache.insert(std::move(key), std::move(value), now);
+}
+
+auto ShardedResponseCache::stats() -> ResponseCacheStats {
+    ResponseCacheStats stats;
+    for (auto& key_shard : shards_) {
+        std::lock_guard lock(key_shard->mutex);
+        stats.hits += key_shard->hits;
+        stats.misses += key_shard->misses;
+        stats.entries += key_shard->cache.size();
+        stats.bytes += key_shard->cache.bytes();
+    }
+    return stats;
+}
+
+auto ShardedResponseCache::shard(std::string const& key) -> Shard& {
+    return *shards_[std::hash<std::string>{}(key) % shards_.size()];
+}
+
+TEST_CASE("[ltb][net] sharded_response_cache counts hits and misses across shards") {
+    using namespace std::chrono_literals;
+
+    auto now   = ShardedResponseCache::Clock::now();
+    auto cache = ShardedResponseCache({1s, 64u, 0u}, 4u);
+
+    for (auto i = 0; i < 32; ++i) {
+        cache.insert("key" + std::to_string(i), "value" + std::to_string(i), now);
+    }
+
+    for (auto i = 0; i < 32; ++i) {
+        auto value = cache.find("key" + std::to_string(i), now);
+        REQUIRE(value);
+        CHECK(*value == "value" + std::to_string(i));
+    }
+    CHECK_FALSE(cache.find("missing", now));
+    CHECK_FALSE(cache.find("key0", now + 2s));
+
+    auto stats = cache.stats();
+    CHECK(stats.hits == 32u);
+    CHECK(stats.misses == 2u);
+    CHECK(stats.entries == 31u);
+    CHECK(stats.bytes > 0u);
+}
+
+} // namespace ltb::net::detail
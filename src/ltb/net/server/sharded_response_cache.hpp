@@ -0,0 +1,78 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// project
+#include "ltb/net/response_cache.hpp"
+
+// standard
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace ltb::net {
+
+struct ResponseCacheStats {
+    std::size_t hits    = 0u;
+    std::size_t misses  = 0u;
+    std::size_t entries = 0u;
+    std::size_t bytes   = 0u;
+};
+
+namespace detail {
+
+/// \brief A ResponseCache split into independently locked shards so concurrent
+///        lookups of different requests rarely contend.
+///
+/// The entry and byte limits are divided evenly between the shards.
+class ShardedResponseCache {
+public:
+    using Clock = ResponseCache::Clock;
+
+    explicit ShardedResponseCache(ResponseCacheOptions options = {}, std::size_t shard_count = 8u);
+
+    /// \brief Returns a copy of the cached value since other threads may evict it.
+    auto find(std::string const& key, Clock::time_point now) -> std::optional<std::string>;
+
+    auto insert(std::string key, std::string value, Clock::time_point now) -> void;
+
+    auto stats() -> ResponseCacheStats;
+
+private:
+    struct Shard {
+        explicit Shard(ResponseCacheOptions options);
+
+        std::mutex    mutex;
+        ResponseCache cache;
+        std::size_t   hits   = 0u;
+        std::size_t   misses = 0u;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    auto shard(std::string const& key) -> Shard&;
+};
+
+} // namespace detail
+} // namespace ltb::net
@@ -0,0 +1,117 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// project
+#include "async_server_unary_writer.hpp"
+
+// standard
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ltb::net::detail {
+
+/// \brief Groups the writers of identical unary requests so one response finishes them all.
+///
+/// Writers may be finished from any thread so the groups are guarded by their own mutex.
+template <typename Response>
+class UnaryRequestCoalescer {
+public:
+    /// \brief Adds 'writer' to the group of requests serialized as 'key'.
+    /// \returns true if 'writer' started a new group and the handler should be invoked.
+    auto join(std::string const& key, AsyncServerUnaryWriter<Response> writer) -> bool;
+
+    /// \brief Removes the group for 'key' and returns all of its writers.
+    auto take(std::string const& key) -> std::vector<AsyncServerUnaryWriter<Response>>;
+
+private:
+    std::mutex                                                                      mutex_;
+    std::unordered_map<std::string, std::vector<AsyncServerUnaryWriter<Response>>> groups_;
+};
+
+/// \brief The writer data handed to the handler of a coalesced request.
+///
+/// Finishing or cancelling it applies to every request in the group.
+template <typename Response>
+struct CoalescedUnaryWriterData : public AsyncServerUnaryWriterData<Response> {
+    explicit CoalescedUnaryWriterData(std::shared_ptr<UnaryRequestCoalescer<Response>> coalescer, std::string key);
+    ~CoalescedUnaryWriterData() override = default;
+
+    auto cancel() -> void override;
+
+    /// \brief Writes 'response' to every request in the group.
+    ///
+    /// gRPC's typed response writers only take messages, which they serialize themselves, so a
+    /// typed response is serialized once per request. Methods registered with
+    /// AsyncServer::register_serialized_rpc write one shared grpc::ByteBuffer to all of them.
+    auto finish(Response const& response, grpc::Status status, void* tag) -> void override;
+
+    std::shared_ptr<UnaryRequestCoalescer<Response>> coalescer;
+    std::string                                      key;
+};
+
+template <typename Response>
+auto UnaryRequestCoalescer<Response>::join(std::string const& key, AsyncServerUnaryWriter<Response> writer) -> bool {
+    std::lock_guard lock(mutex_);
+    auto&           writers = groups_[key];
+    writers.emplace_back(std::move(writer));
+    return writers.size() == 1u;
+}
+
+template <typename Response>
+auto UnaryRequestCoalescer<Response>::take(std::string const& key) -> std::vector<AsyncServerUnaryWriter<Response>> {
+    std::lock_guard lock(mutex_);
+    auto            iter = groups_.find(key);
+    if (iter == groups_.end()) {
+        return {};
+    }
+    auto writers = std::move(iter->second);
+    groups_.erase(iter);
+    return writers;
+}
+
+template <typename Response>
+CoalescedUnaryWriterData<Response>::CoalescedUnaryWriterData(
+    std::shared_ptr<UnaryRequestCoalescer<Response>> request_coalescer, std::string request_key)
+    : coalescer(std::move(request_coalescer)), key(std::move(request_key)) {}
+
+template <typename Response>
+auto CoalescedUnaryWriterData<Response>::cancel() -> void {
+    for (auto& writer : coalescer->take(key)) {
+        writer.cancel();
+    }
+}
+
+template <typename Response>
+auto CoalescedUnaryWriterData<Response>::finish(Response const& response, grpc::Status status, void* /*tag*/)
+    -> void {
+    // The group is removed before finishing so requests arriving from now on start a new one.
+    for (auto& writer : coalescer->take(key)) {
+        writer.finish(response, status);
+    }
+}
+
+} // namespace ltb::net::detail
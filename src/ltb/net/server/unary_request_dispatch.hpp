@@ -0,0 +1,80 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// project
+#include "async_server_callbacks.hpp"
+#include "async_server_unary_writer.hpp"
+#include "caching_unary_writer_data.hpp"
+#include "unary_request_coalescer.hpp"
+
+// standard
+#include <memory>
+
+namespace ltb::net::detail {
+
+/// \brief Hands a unary request to its handler, answering it from the method's response
+///        cache or joining an identical in-flight request first when the method allows it.
+///
+/// Returns the writer data given to the handler (null if the handler was not invoked). The
+/// caller keeps it alive until the call is done since the handler only holds a weak reference.
+template <typename Request, typename Response>
+auto dispatch_unary_request(Request const&                                                   request,
+                            std::shared_ptr<AsyncServerUnaryWriterData<Response>>            writer_data,
+                            void*                                                            tag,
+                            typename ServerCallbacks<Request, Response>::UnaryConnect const& on_connect,
+                            std::shared_ptr<UnaryRequestCoalescer<Response>> const&          coalescer,
+                            std::shared_ptr<ShardedResponseCache> const&                     response_cache)
+    -> std::shared_ptr<AsyncServerUnaryWriterData<Response>> {
+
+    if (!coalescer && !response_cache) {
+        on_connect(request, AsyncServerUnaryWriter<Response>{writer_data, tag});
+        return writer_data;
+    }
+
+    auto key = to_bytes(request);
+
+    if (response_cache) {
+        if (auto cached = response_cache->find(key, ShardedResponseCache::Clock::now())) {
+            writer_data->finish(from_bytes<Response>(*cached), grpc::Status::OK, tag);
+            return nullptr;
+        }
+    }
+
+    if (coalescer) {
+        if (!coalescer->join(key, AsyncServerUnaryWriter<Response>{writer_data, tag})) {
+            return nullptr;
+        }
+        writer_data = std::make_shared<CoalescedUnaryWriterData<Response>>(coalescer, key);
+    }
+
+    if (response_cache) {
+        writer_data = std::make_shared<CachingUnaryWriterData<Response>>(response_cache,
+                                                                         std::move(key),
+                                                                         std::move(writer_data));
+    }
+    on_connect(request, AsyncServerUnaryWriter<Response>{writer_data, tag});
+    return writer_data;
+}
+
+} // namespace ltb::net::detail
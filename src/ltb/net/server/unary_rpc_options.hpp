@@ -0,0 +1,49 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// project
+#include "ltb/net/response_cache.hpp"
+
+namespace ltb::net {
+
+/// \brief Per-method settings for unary rpcs registered with an AsyncServer.
+struct UnaryRpcOptions {
+    /// \brief Run the handler once for concurrent requests with identical bytes.
+    ///
+    /// Requests that arrive while an identical request is being handled wait
+    /// for its result instead of invoking the handler again.
+    bool coalesce_identical_requests = false;
+
+    /// \brief The response depends only on the request so successful responses can be cached.
+    ///
+    /// Cached responses are written when the request arrives without invoking the handler.
+    /// Methods registered with AsyncServer::register_serialized_rpc write the cached bytes
+    /// directly. Typed methods parse them and the response is serialized again.
+    bool pure = false;
+
+    ResponseCacheOptions response_cache        = {};
+    std::size_t          response_cache_shards = 8u;
+};
+
+} // namespace ltb::net
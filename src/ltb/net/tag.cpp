@@ -28,6 +28,8 @@ ClientTag::ClientTag(void* d, ClientTagLabel l) : data(d), label(l) {}
 
 ServerTag::ServerTag(void* d, ServerTagLabel l) : data(d), label(l) {}
 
+ProxyTag::ProxyTag(void* d, ProxyTagLabel l) : data(d), label(l) {}
+
 std::ostream& operator<<(std::ostream& os, const ClientTag& tag) {
     os << '{' << tag.data << ", ";
 
@@ -38,6 +40,9 @@ std::ostream& operator<<(std::ostream& os, const ClientTag& tag) {
     case ClientTagLabel::UnaryFinished:
         os << "ClientTagLabel::UnaryFinished";
         break;
+    case ClientTagLabel::TimerTick:
+        os << "ClientTagLabel::TimerTick";
+        break;
     }
     return os << '}';
 }
@@ -49,49 +54,61 @@ std::ostream& operator<<(std::ostream& os, const ServerTag& tag) {
     case ServerTagLabel::NewRpc:
         os << "ServerTagLabel::NewRpc";
         break;
+    case ServerTagLabel::Reading:
+        os << "ServerTagLabel::Reading";
+        break;
     case ServerTagLabel::Done:
         os << "ServerTagLabel::Done";
         break;
     case ServerTagLabel::Writing:
         os << "ServerTagLabel::Writing";
         break;
+    case ServerTagLabel::Resume:
+        os << "ServerTagLabel::Resume";
+        break;
     }
     return os << '}';
 }
 
-namespace detail {
-
-void* make_tag(void* data, ClientTagLabel label, std::unordered_map<void*, std::unique_ptr<ClientTag>>* tags) {
-    auto&& tag    = std::make_unique<ClientTag>(data, label);
-    void*  result = tag.get();
-    tags->emplace(result, std::forward<decltype(tag)>(tag));
-    return result;
-}
-
-void* make_tag(void* data, ServerTagLabel label, std::unordered_map<void*, std::unique_ptr<ServerTag>>* tags) {
-    auto&& tag    = std::make_unique<ServerTag>(data, label);
-    void*  result = tag.get();
-    tags->emplace(result, std::forward<decltype(tag)>(tag));
-    return result;
-}
-
-ClientTag get_tag(void* key, std::unordered_map<void*, std::unique_ptr<ClientTag>>* tags) {
-    if (tags->find(key) == tags->end()) {
-        throw std::runtime_error("provided client tag does not exist in the map");
-    }
-    ClientTag tag_copy = *tags->at(key);
-    tags->erase(key);
-    return tag_copy;
-}
+std::ostream& operator<<(std::ostream& os, const ProxyTag& tag) {
+    os << '{' << tag.data << ", ";
 
-ServerTag get_tag(void* key, std::unordered_map<void*, std::unique_ptr<ServerTag>>* tags) {
-    if (tags->find(key) == tags->end()) {
-        throw std::runtime_error("provided server tag does not exist in the map");
+    switch (tag.label) {
+    case ProxyTagLabel::NewCall:
+        os << "ProxyTagLabel::NewCall";
+        break;
+    case ProxyTagLabel::DownstreamRead:
+        os << "ProxyTagLabel::DownstreamRead";
+        break;
+    case ProxyTagLabel::DownstreamWrite:
+        os << "ProxyTagLabel::DownstreamWrite";
+        break;
+    case ProxyTagLabel::DownstreamFinish:
+        os << "ProxyTagLabel::DownstreamFinish";
+        break;
+    case ProxyTagLabel::DownstreamDone:
+        os << "ProxyTagLabel::DownstreamDone";
+        break;
+    case ProxyTagLabel::UpstreamStarted:
+        os << "ProxyTagLabel::UpstreamStarted";
+        break;
+    case ProxyTagLabel::UpstreamInitialMetadata:
+        os << "ProxyTagLabel::UpstreamInitialMetadata";
+        break;
+    case ProxyTagLabel::UpstreamRead:
+        os << "ProxyTagLabel::UpstreamRead";
+        break;
+    case ProxyTagLabel::UpstreamWrite:
+        os << "ProxyTagLabel::UpstreamWrite";
+        break;
+    case ProxyTagLabel::UpstreamWritesDone:
+        os << "ProxyTagLabel::UpstreamWritesDone";
+        break;
+    case ProxyTagLabel::UpstreamFinish:
+        os << "ProxyTagLabel::UpstreamFinish";
+        break;
     }
-    ServerTag tag_copy = *tags->at(key);
-    tags->erase(key);
-    return tag_copy;
+    return os << '}';
 }
 
-} // namespace detail
 } // namespace ltb::net
@@ -23,21 +23,36 @@
 #pragma once
 
 // standard
-#include <memory>
 #include <ostream>
-#include <unordered_map>
 
 namespace ltb::net {
 
 enum class ClientTagLabel {
     ConnectionChange,
     UnaryFinished,
+    TimerTick,
 };
 
 enum class ServerTagLabel {
     NewRpc,
+    Reading,
     Writing,
     Done,
+    Resume, ///< Resumes a coroutine suspended on a stream operation
+};
+
+enum class ProxyTagLabel {
+    NewCall,
+    DownstreamRead,
+    DownstreamWrite,
+    DownstreamFinish,
+    DownstreamDone,
+    UpstreamStarted,
+    UpstreamInitialMetadata,
+    UpstreamRead,
+    UpstreamWrite,
+    UpstreamWritesDone,
+    UpstreamFinish,
 };
 
 struct ClientTag {
@@ -54,16 +69,15 @@ struct ServerTag {
     ServerTag(void* d, ServerTagLabel l);
 };
 
-std::ostream& operator<<(std::ostream& os, const ClientTag& tag);
-std::ostream& operator<<(std::ostream& os, const ServerTag& tag);
-
-namespace detail {
+struct ProxyTag {
+    void*         data;
+    ProxyTagLabel label;
 
-void* make_tag(void* data, ClientTagLabel label, std::unordered_map<void*, std::unique_ptr<ClientTag>>* tags);
-void* make_tag(void* data, ServerTagLabel label, std::unordered_map<void*, std::unique_ptr<ServerTag>>* tags);
+    ProxyTag(void* d, ProxyTagLabel l);
+};
 
-ClientTag get_tag(void* key, std::unordered_map<void*, std::unique_ptr<ClientTag>>* tags);
-ServerTag get_tag(void* key, std::unordered_map<void*, std::unique_ptr<ServerTag>>* tags);
+std::ostream& operator<<(std::ostream& os, const ClientTag& tag);
+std::ostream& operator<<(std::ostream& os, const ServerTag& tag);
+std::ostream& operator<<(std::ostream& os, const ProxyTag& tag);
 
-} // namespace detail
 } // namespace ltb::net
@@ -22,26 +22,12 @@
 // ///////////////////////////////////////////////////////////////////////////////////////
 #include "tagger.hpp"
 
-namespace ltb::net {
+namespace ltb::net::detail {
 
-auto ClientTagger::make_tag(void* data, ClientTagLabel label) -> void* {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return detail::make_tag(data, label, &tags_);
-}
-
-auto ClientTagger::get_tag(void* key) -> ClientTag {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return detail::get_tag(key, &tags_);
-}
-
-auto ServerTagger::make_tag(void* data, ServerTagLabel label) -> void* {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return detail::make_tag(data, label, &tags_);
-}
+CompletionTag::~CompletionTag() = default;
 
-auto ServerTagger::get_tag(void* key) -> ServerTag {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return detail::get_tag(key, &tags_);
+auto complete(void* raw_tag, bool completed_successfully) -> void {
+    static_cast<CompletionTag*>(raw_tag)->complete(completed_successfully);
 }
 
-} // namespace ltb::net
+} // namespace ltb::net::detail
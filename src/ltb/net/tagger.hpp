@@ -26,27 +26,124 @@
 #include "tag.hpp"
 
 // standard
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <mutex>
-#include <unordered_map>
 
 namespace ltb::net {
+namespace detail {
 
-struct ClientTagger {
-    auto make_tag(void* data, ClientTagLabel label) -> void*;
-    auto get_tag(void* key) -> ClientTag;
+/// \brief Every tag handed to a completion queue points at one of these so whichever
+///        thread polls the queue (a run() loop or an EventLoop) can dispatch it directly.
+struct CompletionTag {
+    virtual ~CompletionTag() = 0;
 
-public:
-    std::mutex                                            mutex_;
-    std::unordered_map<void*, std::unique_ptr<ClientTag>> tags_;
+    /// \brief Hands the completed operation to its owner and frees the tag.
+    virtual auto complete(bool completed_successfully) -> void = 0;
 };
 
-struct ServerTagger {
-    auto make_tag(void* data, ServerTagLabel label) -> void*;
-    auto get_tag(void* key) -> ServerTag;
+/// \brief Dispatches a tag pulled from a completion queue.
+auto complete(void* raw_tag, bool completed_successfully) -> void;
 
+template <typename Tag, typename TagLabel>
+class Tagger {
 public:
-    std::mutex                                            mutex_;
-    std::unordered_map<void*, std::unique_ptr<ServerTag>> tags_;
+    using Handler = std::function<void(Tag const& tag, bool completed_successfully)>;
+
+    /// \brief Set by the owner of the tags before any are made.
+    auto set_handler(Handler handler) -> void;
+
+    auto make_tag(void* data, TagLabel label) -> void*;
+
+    /// \brief Takes back a tag pulled from a completion queue without dispatching it.
+    auto get_tag(void* key) -> Tag;
+
+    /// \brief Blocks until every tag made by this tagger has been completed, apart from
+    ///        the one being dispatched on the calling thread (if any).
+    auto wait_for_outstanding_tags() -> void;
+
+private:
+    struct Event : public CompletionTag {
+        explicit Event(Tagger& t, Tag tg) : tagger(t), tag(tg) {}
+        ~Event() override = default;
+
+        auto complete(bool completed_successfully) -> void override;
+
+        Tagger& tagger;
+        Tag     tag;
+    };
+
+    Handler                  handler_;
+    std::atomic<std::size_t> outstanding_tags_ = {0u};
+    std::mutex               mutex_;
+    std::condition_variable  all_tags_completed_;
+
+    static thread_local Tagger const* dispatching_tagger_;
+
+    auto release_tag() -> void;
 };
 
+template <typename Tag, typename TagLabel>
+thread_local Tagger<Tag, TagLabel> const* Tagger<Tag, TagLabel>::dispatching_tagger_ = nullptr;
+
+template <typename Tag, typename TagLabel>
+auto Tagger<Tag, TagLabel>::set_handler(Handler handler) -> void {
+    handler_ = std::move(handler);
+}
+
+template <typename Tag, typename TagLabel>
+auto Tagger<Tag, TagLabel>::make_tag(void* data, TagLabel label) -> void* {
+    ++outstanding_tags_;
+    // The queue hands back exactly this pointer, so it has to be the CompletionTag base.
+    return static_cast<CompletionTag*>(new Event(*this, Tag{data, label}));
+}
+
+template <typename Tag, typename TagLabel>
+auto Tagger<Tag, TagLabel>::get_tag(void* key) -> Tag {
+    auto event = std::unique_ptr<Event>(static_cast<Event*>(static_cast<CompletionTag*>(key)));
+    auto tag   = event->tag;
+    event      = nullptr;
+    release_tag();
+    return tag;
+}
+
+template <typename Tag, typename TagLabel>
+auto Tagger<Tag, TagLabel>::wait_for_outstanding_tags() -> void {
+    auto allowed = (dispatching_tagger_ == this ? 1u : 0u);
+
+    std::unique_lock lock(mutex_);
+    all_tags_completed_.wait(lock, [this, allowed] { return outstanding_tags_ <= allowed; });
+}
+
+template <typename Tag, typename TagLabel>
+auto Tagger<Tag, TagLabel>::release_tag() -> void {
+    if (--outstanding_tags_ <= 1u) {
+        // Also wakes a dispatched handler waiting on its own tag.
+        std::lock_guard lock(mutex_);
+        all_tags_completed_.notify_all();
+    }
+}
+
+template <typename Tag, typename TagLabel>
+auto Tagger<Tag, TagLabel>::Event::complete(bool completed_successfully) -> void {
+    auto  completed_tag = tag;
+    auto& owner         = tagger;
+    delete this;
+
+    auto* previous      = dispatching_tagger_;
+    dispatching_tagger_ = &owner;
+    owner.handler_(completed_tag, completed_successfully);
+    dispatching_tagger_ = previous;
+
+    // Released last so the owner cannot be destroyed while its handler is running.
+    owner.release_tag();
+}
+
+} // namespace detail
+
+using ClientTagger = detail::Tagger<ClientTag, ClientTagLabel>;
+using ServerTagger = detail::Tagger<ServerTag, ServerTagLabel>;
+using ProxyTagger  = detail::Tagger<ProxyTag, ProxyTagLabel>;
+
 } // namespace ltb::net
@@ -0,0 +1,128 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "test_service.hpp"
+
+// external
+#include <doctest/doctest.h>
+
+// standard
+#include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+
+namespace ltb::net::test {
+namespace {
+
+struct CallbackCounts {
+    std::atomic_int responses{0};
+    std::atomic_int statuses{0};
+    std::atomic_int errors{0};
+};
+
+/// \brief Makes an echo call whose result is the first error or status message it reports.
+auto counted_echo(AsyncClient<Service>& client,
+                  std::string           msg,
+                  CallbackCounts&       counts,
+                  CallOptions const&    options = {}) -> std::future<std::string> {
+    auto promise = std::make_shared<std::promise<std::string>>();
+
+    client.unary_rpc<TestMessage>(
+        &Service::Stub::Asyncecho,
+        make_message(std::move(msg)),
+        [&counts](TestMessage const& /*response*/) { ++counts.responses; },
+        [&counts, promise](grpc::Status const& status) {
+            if (++counts.statuses + counts.errors == 1) {
+                promise->set_value(status.error_message());
+            }
+        },
+        [&counts, promise](util::Error const& error) {
+            if (++counts.errors + counts.statuses == 1) {
+                promise->set_value(error.error_message());
+            }
+        },
+        options);
+
+    return promise->get_future();
+}
+
+auto with_timeout(util::Duration timeout) -> CallOptions {
+    auto options    = CallOptions{};
+    options.timeout = timeout;
+    return options;
+}
+
+} // namespace
+
+TEST_CASE("[ltb][net] calls that exceed their timeout report it and drop the late response") {
+    auto backend = StalledBackend{};
+    auto client  = AsyncClient<Service>(backend.server.grpc_server());
+
+    auto server_thread = RunThread(backend.server);
+    auto client_thread = RunThread(client);
+
+    auto counts = CallbackCounts{};
+    auto start  = std::chrono::steady_clock::now();
+    auto result = counted_echo(client, "park", counts, with_timeout(std::chrono::milliseconds(50)));
+    REQUIRE(backend.wait_for_parked(1u));
+
+    REQUIRE(is_ready(result));
+    CHECK(result.get() == "Rpc timed out.");
+    CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(50));
+
+    // The handler answers after the client gave up on the call.
+    backend.finish_parked();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    CHECK(counts.errors == 1);
+    CHECK(counts.statuses == 0);
+    CHECK(counts.responses == 0);
+    CHECK(client.stats().outstanding_calls == 0u);
+}
+
+TEST_CASE("[ltb][net] calls without a timeout use the client's default") {
+    auto backend = StalledBackend{};
+    auto client  = AsyncClient<Service>(backend.server.grpc_server());
+    client.set_default_timeout(std::chrono::milliseconds(50));
+
+    auto server_thread = RunThread(backend.server);
+    auto client_thread = RunThread(client);
+
+    auto default_counts = CallbackCounts{};
+    auto defaulted      = counted_echo(client, "park", default_counts);
+    REQUIRE(is_ready(defaulted));
+    CHECK(defaulted.get() == "Rpc timed out.");
+
+    // A zero timeout overrides the default and waits for the handler.
+    auto untimed_counts = CallbackCounts{};
+    auto untimed        = counted_echo(client, "park", untimed_counts, with_timeout(util::Duration::zero()));
+    REQUIRE(backend.wait_for_parked(2u));
+    CHECK(untimed.wait_for(std::chrono::milliseconds(200)) == std::future_status::timeout);
+
+    backend.finish_parked();
+    REQUIRE(is_ready(untimed));
+    CHECK(untimed.get().empty());
+    CHECK(untimed_counts.responses == 1);
+    CHECK(untimed_counts.errors == 0);
+}
+
+} // namespace ltb::net::test
@@ -0,0 +1,79 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "test_service.hpp"
+
+// project
+#include "ltb/net/server/callback_server.hpp"
+
+// external
+#include <doctest/doctest.h>
+
+// standard
+#include <algorithm>
+
+namespace ltb::net::test {
+
+TEST_CASE("[ltb][net] callback_server sends each registered method to its own handler") {
+    auto server = CallbackServer<AsyncService>("");
+
+    // 'echo' is the outermost generated wrapper and 'reverse_echo' the innermost so both ends
+    // of the method index derivation are used.
+    server.register_rpc(&AsyncService::Requestecho,
+                        [](TestMessage const& request, AsyncServerUnaryWriter<TestMessage> writer) {
+                            writer.finish(make_message("echo " + request.msg()), grpc::Status::OK);
+                        });
+    server.register_rpc(&AsyncService::Requestreverse_echo,
+                        [](TestMessage const& request, AsyncServerUnaryWriter<TestMessage> writer) {
+                            auto msg = request.msg();
+                            std::reverse(msg.begin(), msg.end());
+                            writer.finish(make_message("reverse " + msg), grpc::Status::OK);
+                        });
+
+    auto stub = Service::NewStub(server.grpc_server().InProcessChannel({}));
+
+    auto call = [&stub](auto method, std::string msg) {
+        grpc::ClientContext context;
+        context.set_deadline(std::chrono::system_clock::now() + wait_limit);
+
+        auto response = TestMessage{};
+        auto status   = ((*stub).*method)(&context, make_message(std::move(msg)), &response);
+        return (status.ok() ? response.msg() : status.error_message());
+    };
+
+    CHECK(call(&Service::Stub::echo, "abc") == "echo abc");
+    CHECK(call(&Service::Stub::reverse_echo, "abc") == "reverse cba");
+
+    // Methods that are not registered stay async methods without a completion queue, so
+    // nothing ever answers them and calls only end at their deadline.
+    grpc::ClientContext context;
+    context.set_deadline(std::chrono::system_clock::now() + std::chrono::milliseconds(100));
+
+    auto reader   = stub->server_echo_stream(&context, make_message("abc"));
+    auto response = TestMessage{};
+    CHECK_FALSE(reader->Read(&response));
+    CHECK(reader->Finish().error_code() == grpc::StatusCode::DEADLINE_EXCEEDED);
+
+    server.shutdown();
+}
+
+} // namespace ltb::net::test
@@ -0,0 +1,88 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "test_service.hpp"
+
+// project
+#include "ltb/net/server/async_server.hpp"
+
+// external
+#include <doctest/doctest.h>
+
+// standard
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace ltb::net::test {
+
+TEST_CASE("[ltb][net] calls sent before an invalidation don't cache their response") {
+    std::mutex                                       mutex;
+    std::vector<AsyncServerUnaryWriter<TestMessage>> parked;
+    std::atomic_bool                                 park{true};
+    std::atomic_int                                  handled{0};
+
+    auto server = AsyncServer<AsyncService>("");
+    server.register_rpc(&AsyncService::Requestecho,
+                        [&](TestMessage const& /*request*/, AsyncServerUnaryWriter<TestMessage> writer) {
+                            if (park) {
+                                std::lock_guard lock(mutex);
+                                parked.emplace_back(std::move(writer));
+                                ++handled;
+                            } else {
+                                ++handled;
+                                writer.finish(make_message("fresh"), grpc::Status::OK);
+                            }
+                        });
+
+    auto client = AsyncClient<Service>(server.grpc_server());
+    client.enable_response_cache(&Service::Stub::Asyncecho);
+
+    auto server_thread = RunThread(server);
+    auto client_thread = RunThread(client);
+
+    auto stale = echo(client, "key");
+    while (handled == 0) {
+        std::this_thread::yield();
+    }
+
+    client.invalidate_cached_responses(&Service::Stub::Asyncecho);
+    park = false;
+    {
+        std::lock_guard lock(mutex);
+        REQUIRE(parked.size() == 1u);
+        parked.front().finish(make_message("stale"), grpc::Status::OK);
+    }
+    REQUIRE(is_ready(stale));
+    CHECK(stale.get().response == "stale");
+
+    // The stale response wasn't cached so this call reaches the server and caches its response.
+    for (auto i = 0; i < 2; ++i) {
+        auto result = echo(client, "key");
+        REQUIRE(is_ready(result));
+        CHECK(result.get().response == "fresh");
+    }
+    CHECK(handled == 2);
+    CHECK(client.stats().cache_hits == 1u);
+}
+
+} // namespace ltb::net::test
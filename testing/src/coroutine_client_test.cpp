@@ -0,0 +1,210 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#if defined(__cpp_impl_coroutine)
+
+#include "test_service.hpp"
+
+// project
+#include "ltb/net/coro/client_task.hpp"
+#include "ltb/net/server/async_server.hpp"
+
+// external
+#include <doctest/doctest.h>
+
+// standard
+#include <future>
+#include <mutex>
+#include <vector>
+
+namespace ltb::net::test {
+namespace {
+
+/// \brief Completes inline if 'immediate' is set, otherwise when the test resumes it.
+struct ManualAwaitable {
+    int                                   value;
+    bool                                  immediate;
+    std::vector<std::coroutine_handle<>>* suspended;
+
+    auto await_ready() const -> bool { return immediate; }
+    auto await_suspend(std::coroutine_handle<> handle) -> void { suspended->emplace_back(handle); }
+    auto await_resume() const -> int { return value; }
+};
+
+auto await_all(std::vector<ManualAwaitable> awaitables) -> Task<std::vector<int>> {
+    co_return co_await when_all(std::move(awaitables));
+}
+
+auto echo_twice(AsyncClient<Service>& client, std::string msg) -> Task<std::string> {
+    auto first = co_await client.call(&Service::Stub::Asyncecho, make_message(msg));
+    if (!first) {
+        co_return first.error().error_message();
+    }
+    auto second = co_await client.call(&Service::Stub::Asyncecho, make_message(first->msg() + msg));
+    co_return (second ? second->msg() : second.error().error_message());
+}
+
+} // namespace
+
+TEST_CASE("[ltb][net] tasks yield values and complete in order") {
+    auto add_one = [](int value) -> Task<int> { co_return value + 1; };
+    auto add_two = [add_one](int value) -> Task<int> { co_return co_await add_one(co_await add_one(value)); };
+    CHECK(sync_wait(add_two(40)) == 42);
+
+    auto completed = false;
+    sync_wait([](bool& done) -> Task<void> {
+        done = true;
+        co_return;
+    }(completed));
+    CHECK(completed);
+}
+
+TEST_CASE("[ltb][net] when_all only resumes once every awaitable has completed") {
+    auto suspended = std::vector<std::coroutine_handle<>>{};
+
+    auto expected = std::vector<int>{1, 2, 3};
+
+    // Awaitables that complete while when_all is still starting the others.
+    CHECK(sync_wait(await_all({{1, true, &suspended}, {2, true, &suspended}, {3, true, &suspended}})) == expected);
+    CHECK(suspended.empty());
+
+    auto results = std::optional<std::vector<int>>{};
+    [](Task<std::vector<int>> task, std::optional<std::vector<int>>& out) -> detail::DetachedTask {
+        out = co_await std::move(task);
+    }(await_all({{1, false, &suspended}, {2, true, &suspended}, {3, false, &suspended}}), results);
+
+    REQUIRE(suspended.size() == 2u);
+    suspended[1].resume();
+    CHECK_FALSE(results);
+    suspended[0].resume();
+    REQUIRE(results);
+    CHECK(*results == expected);
+}
+
+TEST_CASE("[ltb][net] coroutines await client calls") {
+    std::mutex                                       mutex;
+    std::vector<AsyncServerUnaryWriter<TestMessage>> parked;
+
+    auto server = AsyncServer<AsyncService>("");
+    server.register_rpc(&AsyncService::Requestecho,
+                        [&](TestMessage const& request, AsyncServerUnaryWriter<TestMessage> writer) {
+                            if (request.msg() == "park") {
+                                std::lock_guard lock(mutex);
+                                parked.emplace_back(std::move(writer));
+                            } else {
+                                writer.finish(request, grpc::Status::OK);
+                            }
+                        });
+
+    auto client = AsyncClient<Service>(server.grpc_server());
+
+    auto server_thread = RunThread(server);
+    auto client_thread = RunThread(client);
+
+    auto test_thread = std::this_thread::get_id();
+
+    SUBCASE("tasks compose dependent calls") {
+        CHECK(sync_wait(echo_twice(client, "a")) == "aa");
+    }
+
+    SUBCASE("calls resume on the completion queue thread unless given an executor") {
+        auto resumed_on = [&client](std::optional<ResumeExecutor> executor) -> Task<std::thread::id> {
+            auto call = client.call(&Service::Stub::Asyncecho, make_message("where"));
+            if (executor) {
+                auto result = co_await std::move(call).resume_on(std::move(*executor));
+                CHECK(result);
+            } else {
+                auto result = co_await std::move(call);
+                CHECK(result);
+            }
+            co_return std::this_thread::get_id();
+        };
+
+        auto queue_thread = sync_wait(resumed_on(std::nullopt));
+        CHECK(queue_thread != test_thread);
+
+        auto to_resume       = std::promise<std::function<void()>>{};
+        auto executor_thread = std::thread([resume = to_resume.get_future()]() mutable { resume.get()(); });
+        auto executor        = [&to_resume](std::function<void()> resume) { to_resume.set_value(std::move(resume)); };
+
+        auto executor_resumed_on = sync_wait(resumed_on(executor));
+        auto executor_thread_id  = executor_thread.get_id();
+        executor_thread.join();
+        CHECK(executor_resumed_on == executor_thread_id);
+    }
+
+    SUBCASE("calls that fail before they are sent resume without suspending") {
+        auto no_backends = AsyncClient<Service>(std::vector<std::string>{});
+        auto resumed_on  = sync_wait([&no_backends]() -> Task<std::thread::id> {
+            auto result = co_await no_backends.call(&Service::Stub::Asyncecho, make_message("nowhere"));
+            CHECK_FALSE(result);
+            co_return std::this_thread::get_id();
+        }());
+        CHECK(resumed_on == test_thread);
+    }
+
+    SUBCASE("when_all makes calls concurrently") {
+        using Call = decltype(client.call(&Service::Stub::Asyncecho, TestMessage{}));
+
+        auto responses = sync_wait([&client]() -> Task<std::vector<std::string>> {
+            auto calls = std::vector<Call>{};
+            for (auto const* msg : {"x", "y", "z"}) {
+                calls.emplace_back(client.call(&Service::Stub::Asyncecho, make_message(msg)));
+            }
+            auto messages = std::vector<std::string>{};
+            for (auto& result : co_await when_all(std::move(calls))) {
+                messages.emplace_back(result ? result->msg() : result.error().error_message());
+            }
+            co_return messages;
+        }());
+        auto expected = std::vector<std::string>{"x", "y", "z"};
+        CHECK(responses == expected);
+    }
+
+    SUBCASE("calls rejected by the submit policy resume without suspending") {
+        client.set_max_outstanding_calls(1u, SubmitPolicy::TryLater);
+        auto parked_call = echo(client, "park");
+        while (true) {
+            std::lock_guard lock(mutex);
+            if (!parked.empty()) {
+                break;
+            }
+        }
+
+        auto rejected = sync_wait([&client]() -> Task<std::string> {
+            auto result = co_await client.call(&Service::Stub::Asyncecho, make_message("rejected"));
+            co_return (result ? result->msg() : result.error().error_message());
+        }());
+        CHECK(rejected == "Too many outstanding calls.");
+
+        {
+            std::lock_guard lock(mutex);
+            parked.front().finish(make_message("unparked"), grpc::Status::OK);
+        }
+        REQUIRE(is_ready(parked_call));
+        CHECK(parked_call.get().response == "unparked");
+    }
+}
+
+} // namespace ltb::net::test
+
+#endif // defined(__cpp_impl_coroutine)
@@ -0,0 +1,179 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#if defined(__cpp_impl_coroutine)
+
+#include "test_service.hpp"
+
+// project
+#include "ltb/net/coro/server_task.hpp"
+#include "ltb/net/server/async_server.hpp"
+
+// external
+#include <doctest/doctest.h>
+#include <grpc++/create_channel.h>
+#include <unistd.h>
+
+namespace ltb::net::test {
+
+TEST_CASE("[ltb][net] coroutine handlers serve every kind of stream") {
+    auto address = "unix:/tmp/ltb_net_coroutine_stream_test_" + std::to_string(::getpid()) + ".sock";
+    auto server  = AsyncServer<AsyncService>(address);
+
+    std::promise<void> bidirectional_read_cancelled;
+    std::promise<int>  server_writes_before_cancel;
+
+    // Concatenates every request into one response.
+    server.register_rpc(&AsyncService::Requestclient_echo_stream,
+                        [](AsyncServerReader<TestMessage, TestMessage> stream) -> ServerTask {
+                            auto response = std::string{};
+                            while (auto request = co_await stream.read()) {
+                                response += request->msg();
+                            }
+                            stream.finish(make_message(response), grpc::Status::OK);
+                        });
+
+    server.register_rpc(
+        &AsyncService::Requestserver_echo_stream,
+        [](TestMessage const& request, AsyncServerWriter<TestMessage, TestMessage> stream) -> ServerTask {
+            // Reference parameters aren't copied into the coroutine frame.
+            auto msg = request.msg();
+            for (auto i = 1; i <= 3; ++i) {
+                auto response = make_message(msg + std::to_string(i));
+                if (!co_await stream.write(response)) {
+                    co_return;
+                }
+            }
+            stream.finish(grpc::Status::OK);
+        });
+
+    // Writes until the client cancels.
+    server.register_rpc(
+        &AsyncService::Requestendless_echo_stream,
+        [&server_writes_before_cancel](TestMessage const&                          request,
+                                       AsyncServerWriter<TestMessage, TestMessage> stream) -> ServerTask {
+            auto  response = request;
+            auto  writes   = 0;
+            auto& cancel   = server_writes_before_cancel;
+            while (co_await stream.write(response)) {
+                ++writes;
+            }
+            cancel.set_value(writes);
+            stream.finish(grpc::Status::OK);
+        });
+
+    // Echoes until the client is done, noting reads ended by a cancel.
+    server.register_rpc(
+        &AsyncService::Requestbidirectional_echo_stream,
+        [&bidirectional_read_cancelled](AsyncServerReaderWriter<TestMessage, TestMessage> stream) -> ServerTask {
+            auto& read_cancelled = bidirectional_read_cancelled;
+            auto  cancelled      = false;
+            while (auto request = co_await stream.read()) {
+                cancelled = (request->msg() == "cancel");
+                if (!co_await stream.write(*request)) {
+                    break;
+                }
+            }
+            if (cancelled) {
+                read_cancelled.set_value();
+            }
+            stream.finish(grpc::Status::OK);
+        });
+
+    auto server_thread = RunThread(server);
+
+    auto stub         = Service::NewStub(grpc::CreateChannel(address, grpc::InsecureChannelCredentials()));
+    auto make_context = [] {
+        auto context = std::make_unique<grpc::ClientContext>();
+        context->set_deadline(std::chrono::system_clock::now() + wait_limit);
+        return context;
+    };
+
+    SUBCASE("client streaming") {
+        auto context  = make_context();
+        auto response = TestMessage{};
+        auto writer   = stub->client_echo_stream(context.get(), &response);
+        for (auto const* msg : {"a", "b", "c"}) {
+            REQUIRE(writer->Write(make_message(msg)));
+        }
+        REQUIRE(writer->WritesDone());
+        CHECK(writer->Finish().ok());
+        CHECK(response.msg() == "abc");
+    }
+
+    SUBCASE("server streaming") {
+        auto context  = make_context();
+        auto reader   = stub->server_echo_stream(context.get(), make_message("x"));
+        auto response = TestMessage{};
+        for (auto const* msg : {"x1", "x2", "x3"}) {
+            REQUIRE(reader->Read(&response));
+            CHECK(response.msg() == msg);
+        }
+        CHECK_FALSE(reader->Read(&response));
+        CHECK(reader->Finish().ok());
+    }
+
+    SUBCASE("bidirectional streaming") {
+        auto context = make_context();
+        auto stream  = stub->bidirectional_echo_stream(context.get());
+        auto message = TestMessage{};
+        for (auto const* msg : {"first", "second"}) {
+            REQUIRE(stream->Write(make_message(msg)));
+            REQUIRE(stream->Read(&message));
+            CHECK(message.msg() == msg);
+        }
+        REQUIRE(stream->WritesDone());
+        CHECK_FALSE(stream->Read(&message));
+        CHECK(stream->Finish().ok());
+    }
+
+    SUBCASE("read() yields std::nullopt once the client cancels") {
+        auto read_cancelled = bidirectional_read_cancelled.get_future();
+        auto context        = make_context();
+        auto stream         = stub->bidirectional_echo_stream(context.get());
+        auto message        = TestMessage{};
+        REQUIRE(stream->Write(make_message("cancel")));
+        REQUIRE(stream->Read(&message));
+
+        context->TryCancel();
+        CHECK(stream->Finish().error_code() == grpc::StatusCode::CANCELLED);
+        CHECK(is_ready(read_cancelled));
+    }
+
+    SUBCASE("write() yields false once the client cancels") {
+        auto writes   = server_writes_before_cancel.get_future();
+        auto context  = make_context();
+        auto reader   = stub->endless_echo_stream(context.get(), make_message("again"));
+        auto response = TestMessage{};
+        REQUIRE(reader->Read(&response));
+        CHECK(response.msg() == "again");
+
+        context->TryCancel();
+        CHECK(reader->Finish().error_code() == grpc::StatusCode::CANCELLED);
+        REQUIRE(is_ready(writes));
+        CHECK(writes.get() >= 1);
+    }
+}
+
+} // namespace ltb::net::test
+
+#endif // defined(__cpp_impl_coroutine)
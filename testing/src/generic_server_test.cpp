@@ -0,0 +1,107 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "test_service.hpp"
+
+// project
+#include "ltb/net/event_loop.hpp"
+#include "ltb/net/server/async_generic_server.hpp"
+
+// external
+#include <doctest/doctest.h>
+
+// standard
+#include <algorithm>
+#include <cctype>
+
+namespace ltb::net::test {
+
+TEST_CASE("[ltb][net] the generic server dispatches calls by their method name") {
+    auto server = AsyncGenericServer("");
+
+    server.register_method("/test.Generic/upper",
+                           [](grpc::GenericServerContext const&        /*context*/,
+                              grpc::ByteBuffer const&                  request,
+                              AsyncServerUnaryWriter<grpc::ByteBuffer> writer) {
+                               auto bytes = detail::to_bytes(request);
+                               std::transform(bytes.begin(), bytes.end(), bytes.begin(), [](unsigned char c) {
+                                   return static_cast<char>(std::toupper(c));
+                               });
+                               writer.finish(detail::from_bytes<grpc::ByteBuffer>(bytes), grpc::Status::OK);
+                           });
+    server.register_method("/test.Generic/fail",
+                           [](grpc::GenericServerContext const&        /*context*/,
+                              grpc::ByteBuffer const&                  /*request*/,
+                              AsyncServerUnaryWriter<grpc::ByteBuffer> writer) {
+                               writer.finish({}, grpc::Status{grpc::StatusCode::INVALID_ARGUMENT, "Bad request"});
+                           });
+
+    auto stub          = grpc::GenericStub(server.grpc_server().InProcessChannel({}));
+    auto server_thread = RunThread(server);
+
+    auto upper = generic_call(stub, "/test.Generic/upper", "abc");
+    CHECK(upper.status.ok());
+    CHECK(upper.response == "ABC");
+
+    auto failed = generic_call(stub, "/test.Generic/fail", "abc");
+    CHECK(failed.status.error_code() == grpc::StatusCode::INVALID_ARGUMENT);
+    CHECK(failed.status.error_message() == "Bad request");
+
+    auto unknown = generic_call(stub, "/test.Generic/unknown", "abc");
+    CHECK(unknown.status.error_code() == grpc::StatusCode::UNIMPLEMENTED);
+
+    // The fallback receives every method without its own handler.
+    server.register_fallback([](grpc::GenericServerContext const&        context,
+                                grpc::ByteBuffer const&                  request,
+                                AsyncServerUnaryWriter<grpc::ByteBuffer> writer) {
+        auto response = context.method() + " " + detail::to_bytes(request);
+        writer.finish(detail::from_bytes<grpc::ByteBuffer>(response), grpc::Status::OK);
+    });
+
+    auto fallback = generic_call(stub, "/test.Generic/unknown", "abc");
+    CHECK(fallback.status.ok());
+    CHECK(fallback.response == "/test.Generic/unknown abc");
+
+    auto still_upper = generic_call(stub, "/test.Generic/upper", "abc");
+    CHECK(still_upper.response == "ABC");
+}
+
+TEST_CASE("[ltb][net] the generic server can be polled by an EventLoop") {
+    auto loop   = EventLoop(1u);
+    auto server = AsyncGenericServer(loop, "");
+    server.register_method("/test.Generic/echo",
+                           [](grpc::GenericServerContext const&        /*context*/,
+                              grpc::ByteBuffer const&                  request,
+                              AsyncServerUnaryWriter<grpc::ByteBuffer> writer) {
+                               writer.finish(request, grpc::Status::OK);
+                           });
+
+    auto stub   = grpc::GenericStub(server.grpc_server().InProcessChannel({}));
+    auto result = generic_call(stub, "/test.Generic/echo", "event loop");
+    CHECK(result.status.ok());
+    CHECK(result.response == "event loop");
+
+    server.shutdown();
+    loop.shutdown();
+}
+
+} // namespace ltb::net::test
@@ -0,0 +1,113 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "test_service.hpp"
+
+// project
+#include "ltb/net/client/consistent_hash.hpp"
+#include "ltb/net/server/async_server.hpp"
+
+// external
+#include <doctest/doctest.h>
+#include <unistd.h>
+
+// standard
+#include <atomic>
+
+namespace ltb::net::test {
+
+TEST_CASE("[ltb][net] keyed calls go to their rendezvous backend unless its circuit is open") {
+    auto socket_path = [](std::string const& name) {
+        return "unix:/tmp/ltb_net_key_routing_test_" + std::to_string(::getpid()) + "_" + name + ".sock";
+    };
+    auto addresses = std::vector<std::string>{socket_path("a"), socket_path("b")};
+
+    // Each server answers with its name, and "a" fails while 'a_fails' is set.
+    std::atomic_bool a_fails{false};
+
+    auto server_a = AsyncServer<AsyncService>(addresses[0]);
+    auto server_b = AsyncServer<AsyncService>(addresses[1]);
+    server_a.register_rpc(&AsyncService::Requestecho,
+                          [&a_fails](TestMessage const& /*request*/, AsyncServerUnaryWriter<TestMessage> writer) {
+                              if (a_fails) {
+                                  writer.finish({}, grpc::Status{grpc::StatusCode::UNAVAILABLE, "a is failing"});
+                              } else {
+                                  writer.finish(make_message("a"), grpc::Status::OK);
+                              }
+                          });
+    server_b.register_rpc(&AsyncService::Requestecho,
+                          [](TestMessage const& /*request*/, AsyncServerUnaryWriter<TestMessage> writer) {
+                              writer.finish(make_message("b"), grpc::Status::OK);
+                          });
+
+    auto circuit_breaker                 = CircuitBreakerOptions{};
+    circuit_breaker.consecutive_failures = 1u;
+    circuit_breaker.open_duration        = std::chrono::minutes(1);
+
+    auto client = AsyncClient<Service>(addresses);
+    client.route_by_key(&Service::Stub::Asyncecho, [](TestMessage const& request) { return request.msg(); });
+    client.enable_circuit_breaker(circuit_breaker);
+
+    auto server_a_thread = RunThread(server_a);
+    auto server_b_thread = RunThread(server_b);
+    auto client_thread   = RunThread(client);
+
+    auto call = [&client](std::string const& key) {
+        auto result = echo(client, key);
+        REQUIRE(is_ready(result));
+        return result.get();
+    };
+
+    // Where the client should send each key while both backends are healthy.
+    auto rendezvous_backend = [&addresses](std::string const& key) {
+        auto best = pick_rendezvous(
+            addresses.size(),
+            stable_hash(key),
+            [&addresses](std::size_t i) { return stable_hash(addresses[i]); },
+            [](std::size_t /*i*/) { return true; });
+        return std::string(best == 0u ? "a" : "b");
+    };
+
+    auto keys = std::vector<std::string>{};
+    for (auto i = 0; i < 20; ++i) {
+        keys.emplace_back("key" + std::to_string(i));
+    }
+
+    auto a_key = std::string{};
+    for (auto const& key : keys) {
+        CHECK(call(key).response == rendezvous_backend(key));
+        if (rendezvous_backend(key) == "a") {
+            a_key = key;
+        }
+    }
+    REQUIRE_FALSE(a_key.empty());
+
+    // One failure opens the circuit of "a" so its keys spill over to "b".
+    a_fails = true;
+    CHECK(call(a_key).status.error_code() == grpc::StatusCode::UNAVAILABLE);
+
+    for (auto const& key : keys) {
+        CHECK(call(key).response == "b");
+    }
+}
+
+} // namespace ltb::net::test
@@ -0,0 +1,207 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "test_service.hpp"
+
+// project
+#include "ltb/net/event_loop.hpp"
+#include "ltb/net/proxy/async_proxy.hpp"
+
+// external
+#include <doctest/doctest.h>
+#include <grpc++/create_channel.h>
+#include <grpc++/server_builder.h>
+#include <unistd.h>
+
+// standard
+#include <map>
+
+namespace ltb::net::test {
+namespace {
+
+using namespace std::chrono_literals;
+
+/// \brief Echoes messages and the client's "x-request" metadata, and fails "fail" requests.
+class EchoBackend : public Service::Service {
+public:
+    std::promise<void> stream_cancelled;
+
+    auto echo(grpc::ServerContext* context, TestMessage const* request, TestMessage* response)
+        -> grpc::Status override {
+        echo_metadata(context);
+        if (request->msg() == "fail") {
+            return grpc::Status{grpc::StatusCode::INVALID_ARGUMENT, "The backend failed"};
+        }
+        response->set_msg(request->msg());
+        return grpc::Status::OK;
+    }
+
+    auto bidirectional_echo_stream(grpc::ServerContext*                                 context,
+                                   grpc::ServerReaderWriter<TestMessage, TestMessage>* stream)
+        -> grpc::Status override {
+        echo_metadata(context);
+        stream->SendInitialMetadata();
+
+        auto message = TestMessage{};
+        auto slow    = false;
+        while (stream->Read(&message)) {
+            slow = (message.msg() == "slow");
+            stream->Write(message);
+        }
+
+        // A cancel can arrive after the reads have ended, so "slow" calls stay busy until it does.
+        auto busy_until = std::chrono::steady_clock::now() + (slow ? wait_limit : 0s);
+        while (!context->IsCancelled() && std::chrono::steady_clock::now() < busy_until) {
+            std::this_thread::sleep_for(1ms);
+        }
+        if (context->IsCancelled()) {
+            stream_cancelled.set_value();
+        }
+        return grpc::Status::OK;
+    }
+
+private:
+    static auto echo_metadata(grpc::ServerContext* context) -> void {
+        for (auto const& [key, value] : context->client_metadata()) {
+            if (key == "x-request") {
+                context->AddInitialMetadata("x-initial", std::string(value.data(), value.length()));
+                context->AddTrailingMetadata("x-trailing", std::string(value.data(), value.length()));
+            }
+        }
+    }
+};
+
+auto find_metadata(std::multimap<grpc::string_ref, grpc::string_ref> const& metadata, std::string const& key)
+    -> std::string {
+    auto iter = metadata.find(key);
+    return iter == metadata.end() ? "" : std::string(iter->second.data(), iter->second.length());
+}
+
+auto make_context(std::string const& request_metadata) -> std::unique_ptr<grpc::ClientContext> {
+    auto context = std::make_unique<grpc::ClientContext>();
+    context->AddMetadata("x-request", request_metadata);
+    context->set_deadline(std::chrono::system_clock::now() + wait_limit);
+    return context;
+}
+
+} // namespace
+
+TEST_CASE("[ltb][net] the proxy forwards calls, metadata, status and cancellation") {
+    auto socket_prefix   = "unix:/tmp/ltb_net_proxy_test_" + std::to_string(::getpid());
+    auto backend_address = socket_prefix + "_backend.sock";
+    auto proxy_address   = socket_prefix + "_proxy.sock";
+
+    auto backend = EchoBackend{};
+    auto builder = grpc::ServerBuilder{};
+    builder.AddListeningPort(backend_address, grpc::InsecureServerCredentials());
+    builder.RegisterService(&backend);
+    auto backend_server = builder.BuildAndStart();
+    REQUIRE(backend_server);
+
+    auto proxy = AsyncProxy(proxy_address);
+    proxy.set_default_backend(backend_address);
+    auto proxy_thread = RunThread(proxy);
+
+    auto stub = Service::NewStub(grpc::CreateChannel(proxy_address, grpc::InsecureChannelCredentials()));
+
+    SUBCASE("unary") {
+        auto context  = make_context("unary");
+        auto response = TestMessage{};
+        auto status   = stub->echo(context.get(), make_message("hello"), &response);
+
+        CHECK(status.ok());
+        CHECK(response.msg() == "hello");
+        CHECK(find_metadata(context->GetServerInitialMetadata(), "x-initial") == "unary");
+        CHECK(find_metadata(context->GetServerTrailingMetadata(), "x-trailing") == "unary");
+
+        auto failed_context = make_context("failed");
+        status              = stub->echo(failed_context.get(), make_message("fail"), &response);
+
+        CHECK(status.error_code() == grpc::StatusCode::INVALID_ARGUMENT);
+        CHECK(status.error_message() == "The backend failed");
+        CHECK(find_metadata(failed_context->GetServerTrailingMetadata(), "x-trailing") == "failed");
+    }
+
+    SUBCASE("bidirectional stream") {
+        auto context = make_context("stream");
+        auto stream  = stub->bidirectional_echo_stream(context.get());
+        auto message = TestMessage{};
+
+        for (auto const* msg : {"first", "second", "third"}) {
+            REQUIRE(stream->Write(make_message(msg)));
+            REQUIRE(stream->Read(&message));
+            CHECK(message.msg() == msg);
+        }
+        CHECK(find_metadata(context->GetServerInitialMetadata(), "x-initial") == "stream");
+
+        REQUIRE(stream->WritesDone());
+        CHECK_FALSE(stream->Read(&message));
+        CHECK(stream->Finish().ok());
+        CHECK(find_metadata(context->GetServerTrailingMetadata(), "x-trailing") == "stream");
+    }
+
+    SUBCASE("cancelled stream") {
+        auto cancelled = backend.stream_cancelled.get_future();
+        auto context   = make_context("cancelled");
+        auto stream    = stub->bidirectional_echo_stream(context.get());
+        auto message   = TestMessage{};
+
+        REQUIRE(stream->Write(make_message("slow")));
+        REQUIRE(stream->Read(&message));
+
+        context->TryCancel();
+        CHECK(stream->Finish().error_code() == grpc::StatusCode::CANCELLED);
+
+        // The backend sees a cancel rather than the end of the client's messages.
+        CHECK(is_ready(cancelled));
+    }
+}
+
+TEST_CASE("[ltb][net] the proxy runs on an EventLoop") {
+    auto socket_prefix   = "unix:/tmp/ltb_net_proxy_loop_test_" + std::to_string(::getpid());
+    auto backend_address = socket_prefix + "_backend.sock";
+    auto proxy_address   = socket_prefix + "_proxy.sock";
+
+    auto backend = EchoBackend{};
+    auto builder = grpc::ServerBuilder{};
+    builder.AddListeningPort(backend_address, grpc::InsecureServerCredentials());
+    builder.RegisterService(&backend);
+    auto backend_server = builder.BuildAndStart();
+    REQUIRE(backend_server);
+
+    auto loop  = EventLoop(1u);
+    auto proxy = AsyncProxy(loop, proxy_address);
+    proxy.set_default_backend(backend_address);
+
+    auto stub = Service::NewStub(grpc::CreateChannel(proxy_address, grpc::InsecureChannelCredentials()));
+
+    auto context  = make_context("loop");
+    auto response = TestMessage{};
+    CHECK(stub->echo(context.get(), make_message("loop"), &response).ok());
+    CHECK(response.msg() == "loop");
+
+    proxy.shutdown();
+    loop.shutdown();
+    backend_server->Shutdown();
+}
+
+} // namespace ltb::net::test
@@ -0,0 +1,128 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "test_service.hpp"
+
+// external
+#include <doctest/doctest.h>
+
+// standard
+#include <future>
+#include <vector>
+
+namespace ltb::net::test {
+namespace {
+
+/// \brief Makes identical calls that the client coalesces into the first one.
+auto park_identical_calls(AsyncClient<Service>& client, StalledBackend& backend, CallOptions const& options = {})
+    -> std::vector<std::future<CallResult>> {
+    auto results = std::vector<std::future<CallResult>>{};
+    for (auto i = 0; i < 3; ++i) {
+        results.emplace_back(echo(client, "park", options));
+    }
+    REQUIRE(backend.wait_for_parked(1u));
+    return results;
+}
+
+} // namespace
+
+TEST_CASE("[ltb][net] identical calls share one outstanding call") {
+    auto backend = StalledBackend{};
+    auto client  = AsyncClient<Service>(backend.server.grpc_server());
+    client.enable_request_coalescing(&Service::Stub::Asyncecho);
+
+    auto server_thread = RunThread(backend.server);
+    auto client_thread = RunThread(client);
+
+    auto results = park_identical_calls(client, backend);
+    CHECK(client.stats().coalesced_calls == 2u);
+    CHECK(client.stats().outstanding_calls == 1u);
+
+    // A different request isn't coalesced.
+    auto other = echo(client, "other");
+    REQUIRE(is_ready(other));
+    CHECK(other.get().response == "other");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    {
+        std::lock_guard lock(backend.mutex);
+        CHECK(backend.parked.size() == 1u);
+    }
+    backend.finish_parked();
+
+    for (auto& result : results) {
+        REQUIRE(is_ready(result));
+        auto call_result = result.get();
+        CHECK(call_result.status.ok());
+        CHECK(call_result.response == "unparked");
+    }
+    CHECK(client.stats().coalesced_calls == 2u);
+
+    // Calls made after the shared call finished are sent again.
+    auto later = echo(client, "park");
+    REQUIRE(backend.wait_for_parked(1u));
+    backend.finish_parked();
+    REQUIRE(is_ready(later));
+    CHECK(later.get().response == "unparked");
+    CHECK(client.stats().coalesced_calls == 2u);
+}
+
+TEST_CASE("[ltb][net] every coalesced call gets the shared call's error status") {
+    auto backend = StalledBackend{};
+    auto client  = AsyncClient<Service>(backend.server.grpc_server());
+    client.enable_request_coalescing(&Service::Stub::Asyncecho);
+
+    auto server_thread = RunThread(backend.server);
+    auto client_thread = RunThread(client);
+
+    auto results = park_identical_calls(client, backend);
+    backend.finish_parked({grpc::StatusCode::INVALID_ARGUMENT, "rejected"});
+
+    for (auto& result : results) {
+        REQUIRE(is_ready(result));
+        auto call_result = result.get();
+        CHECK(call_result.status.error_code() == grpc::StatusCode::INVALID_ARGUMENT);
+        CHECK(call_result.status.error_message() == "rejected");
+        CHECK(call_result.response.empty());
+    }
+}
+
+TEST_CASE("[ltb][net] every coalesced call times out with the shared call") {
+    auto backend = StalledBackend{};
+    auto client  = AsyncClient<Service>(backend.server.grpc_server());
+    client.enable_request_coalescing(&Service::Stub::Asyncecho);
+
+    auto server_thread = RunThread(backend.server);
+    auto client_thread = RunThread(client);
+
+    auto options    = CallOptions{};
+    options.timeout = std::chrono::milliseconds(50);
+
+    for (auto& result : park_identical_calls(client, backend, options)) {
+        REQUIRE(is_ready(result));
+        CHECK(result.get().error == "Rpc timed out.");
+    }
+    CHECK(client.stats().coalesced_calls == 2u);
+    CHECK(client.stats().outstanding_calls == 0u);
+}
+
+} // namespace ltb::net::test
@@ -0,0 +1,75 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "test_service.hpp"
+
+// project
+#include "ltb/net/server/async_server_serialized_writer.hpp"
+#include "ltb/net/server/serialized_response.hpp"
+
+// external
+#include <doctest/doctest.h>
+
+namespace ltb::net::test {
+
+TEST_CASE("[ltb][net] raw methods parse requests and write pre-serialized responses") {
+    using RawEchoService = Service::WithRawMethod_echo<AsyncService>;
+
+    auto greeting = SerializedResponse<TestMessage>(make_message("hello"));
+    REQUIRE(greeting.status().ok());
+
+    auto server = AsyncServer<RawEchoService>("");
+    server.register_serialized_rpc<TestMessage, TestMessage>(
+        &RawEchoService::Requestecho,
+        [&greeting](TestMessage const& request, AsyncServerSerializedWriter<TestMessage> writer) {
+            if (request.msg() == "greet") {
+                writer.finish(greeting, grpc::Status::OK);
+            } else {
+                writer.finish(request, grpc::Status::OK);
+            }
+        });
+
+    // Typed clients can't tell the method is raw on the server.
+    auto client = AsyncClient<Service>(server.grpc_server());
+    auto stub   = grpc::GenericStub(server.grpc_server().InProcessChannel({}));
+
+    auto server_thread = RunThread(server);
+    auto client_thread = RunThread(client);
+
+    for (auto i = 0; i < 2; ++i) {
+        auto greeted = echo(client, "greet");
+        REQUIRE(is_ready(greeted));
+        auto greeted_result = greeted.get();
+        CHECK(greeted_result.status.ok());
+        CHECK(greeted_result.response == "hello");
+    }
+
+    auto echoed = echo(client, "echo");
+    REQUIRE(is_ready(echoed));
+    CHECK(echoed.get().response == "echo");
+
+    // A length-delimited field that runs past the end of the message.
+    auto unparsable = generic_call(stub, "/grpcw.testing.protocol.Test/echo", "\x0a\x10truncated");
+    CHECK(unparsable.status.error_code() == grpc::StatusCode::INVALID_ARGUMENT);
+}
+
+} // namespace ltb::net::test
@@ -0,0 +1,96 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "test_service.hpp"
+
+// external
+#include <doctest/doctest.h>
+
+// standard
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace ltb::net::test {
+
+TEST_CASE("[ltb][net] the server coalesces identical requests sent over gRPC") {
+    std::mutex                                       mutex;
+    std::vector<AsyncServerUnaryWriter<TestMessage>> parked;
+    std::atomic_int                                  handled{0};
+
+    auto server = AsyncServer<AsyncService>("");
+
+    auto options                        = UnaryRpcOptions{};
+    options.coalesce_identical_requests = true;
+    server.register_rpc(
+        &AsyncService::Requestecho,
+        [&](TestMessage const& request, AsyncServerUnaryWriter<TestMessage> writer) {
+            std::lock_guard lock(mutex);
+            if (request.msg() == "park") {
+                parked.emplace_back(std::move(writer));
+            } else {
+                writer.finish(request, grpc::Status::OK);
+            }
+            ++handled;
+        },
+        nullptr,
+        options);
+
+    // The client doesn't coalesce or dispatch locally so every call reaches the server over its channel.
+    auto client = AsyncClient<Service>(server.grpc_server());
+
+    auto server_thread = RunThread(server);
+    auto client_thread = RunThread(client);
+
+    std::vector<std::future<CallResult>> results;
+    for (auto i = 0; i < 3; ++i) {
+        results.emplace_back(echo(client, "park"));
+    }
+    while (handled == 0) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // Different requests still reach the handler while the first one is parked.
+    auto other = echo(client, "other");
+    REQUIRE(is_ready(other));
+    CHECK(other.get().response == "other");
+    CHECK(client.stats().outstanding_calls == 3u);
+
+    {
+        std::lock_guard lock(mutex);
+        CHECK(parked.size() == 1u);
+        for (auto& writer : parked) {
+            writer.finish(make_message("shared"), grpc::Status::OK);
+        }
+    }
+
+    for (auto& result : results) {
+        REQUIRE(is_ready(result));
+        auto call_result = result.get();
+        CHECK(call_result.status.ok());
+        CHECK(call_result.response == "shared");
+    }
+    CHECK(handled == 2);
+}
+
+} // namespace ltb::net::test
@@ -0,0 +1,75 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "test_service.hpp"
+
+// external
+#include <doctest/doctest.h>
+
+// standard
+#include <atomic>
+
+namespace ltb::net::test {
+
+TEST_CASE("[ltb][net] the server answers repeated requests sent over gRPC from its response cache") {
+    std::atomic_int handled{0};
+
+    auto server = AsyncServer<AsyncService>("");
+
+    auto options = UnaryRpcOptions{};
+    options.pure = true;
+    server.register_rpc(
+        &AsyncService::Requestecho,
+        [&handled](TestMessage const& request, AsyncServerUnaryWriter<TestMessage> writer) {
+            ++handled;
+            writer.finish(make_message(request.msg() + std::to_string(handled)), grpc::Status::OK);
+        },
+        nullptr,
+        options);
+
+    // The client has no cache of its own so every call reaches the server over its channel.
+    auto client = AsyncClient<Service>(server.grpc_server());
+
+    auto server_thread = RunThread(server);
+    auto client_thread = RunThread(client);
+
+    auto call = [&client](std::string const& msg) {
+        auto result = echo(client, msg);
+        REQUIRE(is_ready(result));
+        auto call_result = result.get();
+        CHECK(call_result.status.ok());
+        return call_result.response;
+    };
+
+    CHECK(call("a") == "a1");
+    CHECK(call("a") == "a1");
+    CHECK(call("b") == "b2");
+    CHECK(call("a") == "a1");
+    CHECK(handled == 2);
+
+    auto stats = server.stats();
+    CHECK(stats.response_cache.hits == 2u);
+    CHECK(stats.response_cache.misses == 2u);
+    CHECK(stats.response_cache.entries == 2u);
+}
+
+} // namespace ltb::net::test
@@ -0,0 +1,222 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#include "test_service.hpp"
+
+// external
+#include <doctest/doctest.h>
+
+// standard
+#include <future>
+#include <string>
+
+namespace ltb::net::test {
+namespace {
+
+/// \brief Makes an echo call on another thread since it may block.
+auto echo_from_thread(AsyncClient<Service>& client, std::string msg) -> std::future<std::future<CallResult>> {
+    return std::async(std::launch::async, [&client, msg = std::move(msg)] { return echo(client, msg); });
+}
+
+auto still_blocked(std::future<std::future<CallResult>> const& submitted) -> bool {
+    return submitted.wait_for(std::chrono::milliseconds(50)) == std::future_status::timeout;
+}
+
+} // namespace
+
+TEST_CASE("[ltb][net] FailFast rejects calls over the limit and invokes their ErrorCallback") {
+    auto backend = StalledBackend{};
+    auto client  = AsyncClient<Service>(backend.server.grpc_server());
+    client.set_max_outstanding_calls(1u, SubmitPolicy::FailFast);
+
+    auto server_thread = RunThread(backend.server);
+    auto client_thread = RunThread(client);
+
+    auto parked = echo(client, "park");
+    REQUIRE(backend.wait_for_parked(1u));
+
+    auto stats = client.stats();
+    CHECK(stats.outstanding_calls == 1u);
+    CHECK(stats.max_outstanding_calls == 1u);
+    CHECK(stats.rejected_calls == 0u);
+
+    auto rejected = echo(client, "rejected");
+    REQUIRE(is_ready(rejected));
+    CHECK(rejected.get().error == "Too many outstanding calls.");
+    CHECK(client.stats().rejected_calls == 1u);
+
+    backend.finish_parked();
+    REQUIRE(is_ready(parked));
+    CHECK(parked.get().response == "unparked");
+    CHECK(client.stats().outstanding_calls == 0u);
+
+    auto accepted = echo(client, "accepted");
+    REQUIRE(is_ready(accepted));
+    CHECK(accepted.get().response == "accepted");
+}
+
+TEST_CASE("[ltb][net] TryLater rejects calls over the limit without invoking callbacks") {
+    auto backend = StalledBackend{};
+    auto client  = AsyncClient<Service>(backend.server.grpc_server());
+    client.set_max_outstanding_calls(1u, SubmitPolicy::TryLater);
+
+    auto server_thread = RunThread(backend.server);
+    auto client_thread = RunThread(client);
+
+    auto parked = echo(client, "park");
+    REQUIRE(backend.wait_for_parked(1u));
+
+    auto callbacks_called = false;
+    auto result           = client.unary_rpc<TestMessage>(
+        &Service::Stub::Asyncecho,
+        make_message("later"),
+        [&callbacks_called](TestMessage const& /*response*/) { callbacks_called = true; },
+        [&callbacks_called](grpc::Status const& /*status*/) { callbacks_called = true; },
+        [&callbacks_called](util::Error const& /*error*/) { callbacks_called = true; });
+    CHECK(result == SubmitResult::TryLater);
+    CHECK_FALSE(callbacks_called);
+    CHECK(client.stats().rejected_calls == 1u);
+
+    backend.finish_parked();
+    REQUIRE(is_ready(parked));
+
+    auto retried = echo(client, "later");
+    REQUIRE(is_ready(retried));
+    CHECK(retried.get().response == "later");
+}
+
+TEST_CASE("[ltb][net] Block waits until an outstanding call finishes") {
+    auto backend = StalledBackend{};
+    auto client  = AsyncClient<Service>(backend.server.grpc_server());
+    client.set_max_outstanding_calls(1u, SubmitPolicy::Block);
+
+    auto server_thread = RunThread(backend.server);
+    auto client_thread = RunThread(client);
+
+    auto parked = echo(client, "park");
+    REQUIRE(backend.wait_for_parked(1u));
+
+    auto blocked = echo_from_thread(client, "blocked");
+    CHECK(still_blocked(blocked));
+    CHECK(client.stats().rejected_calls == 0u);
+
+    backend.finish_parked();
+    REQUIRE(is_ready(parked));
+    REQUIRE(is_ready(blocked));
+    auto result = blocked.get();
+    REQUIRE(is_ready(result));
+    CHECK(result.get().response == "blocked");
+    CHECK(client.stats().rejected_calls == 0u);
+}
+
+TEST_CASE("[ltb][net] Block releases waiting callers when the client shuts down") {
+    auto backend = StalledBackend{};
+    auto client  = AsyncClient<Service>(backend.server.grpc_server());
+    client.set_max_outstanding_calls(1u, SubmitPolicy::Block);
+
+    auto server_thread = RunThread(backend.server);
+    auto client_thread = RunThread(client);
+
+    auto parked = echo(client, "park");
+    REQUIRE(backend.wait_for_parked(1u));
+
+    auto blocked = echo_from_thread(client, "blocked");
+    CHECK(still_blocked(blocked));
+
+    client.shutdown();
+    REQUIRE(is_ready(blocked));
+    auto result = blocked.get();
+    REQUIRE(is_ready(result));
+    CHECK(result.get().error == "No backends available.");
+    REQUIRE(is_ready(parked));
+}
+
+TEST_CASE("[ltb][net] Block rejects waiting callers once every circuit is open") {
+    auto backend = StalledBackend{};
+    auto client  = AsyncClient<Service>(backend.server.grpc_server());
+    client.set_max_outstanding_calls(1u, SubmitPolicy::Block);
+
+    auto circuit_breaker                 = CircuitBreakerOptions{};
+    circuit_breaker.consecutive_failures = 1u;
+    circuit_breaker.open_duration        = std::chrono::minutes(1);
+    client.enable_circuit_breaker(circuit_breaker);
+
+    auto server_thread = RunThread(backend.server);
+    auto client_thread = RunThread(client);
+
+    auto parked = echo(client, "park");
+    REQUIRE(backend.wait_for_parked(1u));
+
+    auto blocked = echo_from_thread(client, "blocked");
+    CHECK(still_blocked(blocked));
+
+    // The failure opens the only circuit, so nothing would ever wake the blocked caller again.
+    backend.finish_parked({grpc::StatusCode::UNAVAILABLE, "stalled"});
+    REQUIRE(is_ready(parked));
+    REQUIRE(is_ready(blocked));
+    auto result = blocked.get();
+    REQUIRE(is_ready(result));
+    CHECK(result.get().error == "Circuit breaker open.");
+
+    auto rejected = echo(client, "rejected");
+    REQUIRE(is_ready(rejected));
+    CHECK(rejected.get().error == "Circuit breaker open.");
+    CHECK(client.stats().rejected_calls == 2u);
+}
+
+TEST_CASE("[ltb][net] per-method limits only apply to their own method") {
+    auto backend = StalledBackend{};
+    backend.server.register_rpc(&AsyncService::Requestreverse_echo,
+                                [](TestMessage const& request, AsyncServerUnaryWriter<TestMessage> writer) {
+                                    writer.finish(request, grpc::Status::OK);
+                                });
+
+    auto client = AsyncClient<Service>(backend.server.grpc_server());
+    client.set_max_outstanding_calls(&Service::Stub::Asyncecho, 1u);
+
+    auto server_thread = RunThread(backend.server);
+    auto client_thread = RunThread(client);
+
+    auto parked = echo(client, "park");
+    REQUIRE(backend.wait_for_parked(1u));
+    CHECK(client.outstanding_calls(&Service::Stub::Asyncecho) == 1u);
+
+    auto rejected = echo(client, "rejected");
+    REQUIRE(is_ready(rejected));
+    CHECK(rejected.get().error == "Too many outstanding calls.");
+
+    auto other_method = std::promise<std::string>{};
+    client.unary_rpc<TestMessage>(&Service::Stub::Asyncreverse_echo,
+                                  make_message("other"),
+                                  [&other_method](TestMessage const& response) {
+                                      other_method.set_value(response.msg());
+                                  });
+    auto other_response = other_method.get_future();
+    REQUIRE(is_ready(other_response));
+    CHECK(other_response.get() == "other");
+
+    backend.finish_parked();
+    REQUIRE(is_ready(parked));
+    CHECK(client.outstanding_calls(&Service::Stub::Asyncecho) == 0u);
+}
+
+} // namespace ltb::net::test
@@ -0,0 +1,180 @@
+// ///////////////////////////////////////////////////////////////////////////////////////
+// LTB Networking
+// Copyright (c) 2020 Logan Barnes - All Rights Reserved
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ///////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// generated
+#include "testing.grpc.pb.h"
+
+// project
+#include "ltb/net/client/async_client.hpp"
+#include "ltb/net/server/async_server.hpp"
+#include "ltb/net/server/message_bytes.hpp"
+
+// external
+#include <grpc++/generic/generic_stub.h>
+
+// standard
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ltb::net::test {
+
+using Service      = grpcw::testing::protocol::Test;
+using AsyncService = Service::AsyncService;
+using TestMessage  = grpcw::testing::protocol::TestMessage;
+
+/// \brief How long tests wait for something that should happen right away.
+constexpr auto wait_limit = std::chrono::seconds(5);
+
+inline auto make_message(std::string msg) -> TestMessage {
+    TestMessage message;
+    message.set_msg(std::move(msg));
+    return message;
+}
+
+/// \brief Calls 'run()' on its own thread and 'shutdown()' when it goes out of scope.
+template <typename Runnable>
+class RunThread {
+public:
+    explicit RunThread(Runnable& runnable) : runnable_(runnable), thread_([&runnable] { runnable.run(); }) {}
+    ~RunThread() {
+        runnable_.shutdown();
+        thread_.join();
+    }
+
+    RunThread(RunThread const&) = delete;
+    auto operator=(RunThread const&) -> RunThread& = delete;
+
+private:
+    Runnable&   runnable_;
+    std::thread thread_;
+};
+
+template <typename Result>
+auto is_ready(std::future<Result> const& future) -> bool {
+    return future.wait_for(wait_limit) == std::future_status::ready;
+}
+
+struct CallResult {
+    grpc::Status               status   = {grpc::StatusCode::UNKNOWN, "The call has no status."};
+    std::string                response = {};
+    std::optional<std::string> error    = std::nullopt; ///< Set instead of the status if the call failed
+};
+
+/// \brief Makes an echo call whose result is set once its callbacks have run.
+inline auto echo(AsyncClient<Service>& client, std::string msg, CallOptions const& options = {})
+    -> std::future<CallResult> {
+    auto result  = std::make_shared<CallResult>();
+    auto promise = std::make_shared<std::promise<CallResult>>();
+
+    client.unary_rpc<TestMessage>(
+        &Service::Stub::Asyncecho,
+        make_message(std::move(msg)),
+        [result](TestMessage const& response) { result->response = response.msg(); },
+        [result, promise](grpc::Status const& status) {
+            result->status = status;
+            promise->set_value(*result);
+        },
+        [result, promise](util::Error const& error) {
+            result->error = error.error_message();
+            promise->set_value(*result);
+        },
+        options);
+
+    return promise->get_future();
+}
+
+/// \brief Makes a unary call with a raw payload and waits for its result.
+inline auto generic_call(grpc::GenericStub& stub, std::string const& method, std::string const& request) -> CallResult {
+    grpc::ClientContext context;
+    context.set_deadline(std::chrono::system_clock::now() + wait_limit);
+
+    grpc::CompletionQueue queue;
+    auto                  result   = CallResult{};
+    auto                  response = grpc::ByteBuffer{};
+
+    auto reader = stub.PrepareUnaryCall(&context, method, detail::from_bytes<grpc::ByteBuffer>(request), &queue);
+    reader->StartCall();
+    reader->Finish(&response, &result.status, &context);
+
+    void* raw_tag                = {};
+    bool  completed_successfully = {};
+    queue.Next(&raw_tag, &completed_successfully);
+    queue.Shutdown();
+    while (queue.Next(&raw_tag, &completed_successfully)) {
+    }
+
+    if (result.status.ok()) {
+        result.response = detail::to_bytes(response);
+    }
+    return result;
+}
+
+/// \brief An echo server that parks calls for "park" until the test finishes them.
+struct StalledBackend {
+    std::mutex                                       mutex;
+    std::vector<AsyncServerUnaryWriter<TestMessage>> parked;
+    AsyncServer<AsyncService>                        server{""};
+
+    StalledBackend() {
+        server.register_rpc(&AsyncService::Requestecho,
+                            [this](TestMessage const& request, AsyncServerUnaryWriter<TestMessage> writer) {
+                                if (request.msg() == "park") {
+                                    std::lock_guard lock(mutex);
+                                    parked.emplace_back(std::move(writer));
+                                } else {
+                                    writer.finish(request, grpc::Status::OK);
+                                }
+                            });
+    }
+
+    auto wait_for_parked(std::size_t count) -> bool {
+        auto deadline = std::chrono::steady_clock::now() + wait_limit;
+        while (std::chrono::steady_clock::now() < deadline) {
+            {
+                std::lock_guard lock(mutex);
+                if (parked.size() >= count) {
+                    return true;
+                }
+            }
+            std::this_thread::yield();
+        }
+        return false;
+    }
+
+    auto finish_parked(grpc::Status const& status = grpc::Status::OK) -> void {
+        std::lock_guard lock(mutex);
+        for (auto& writer : parked) {
+            writer.finish(make_message("unparked"), status);
+        }
+        parked.clear();
+    }
+};
+
+} // namespace ltb::net::test